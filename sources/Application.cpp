@@ -26,6 +26,7 @@
  */
 
 #include "Application.hpp"
+#include "KernelRegistry.hpp"
 #include "ResourcePath.hpp"
 #include <Thor/Shapes.hpp>
 #include <sstream>
@@ -35,6 +36,13 @@ namespace {
 	const std::string info =
 	std::string("Press P/M to zoom in and out\n") +
 	"Press O/L to increase/decrease the fractal rendering precision\n" +
+	"Press C to enable/disable the periodicity checking\n" +
+	"Press I to enable/disable the proof of tiles inside the set\n" +
+	"Press A/Z to rotate the view\n" +
+	"Press V to change the coloring\n" +
+	"Press G to change the rendering mode\n" +
+	"Press K to enable/disable the verification of guessed pixels\n" +
+	"Press X to enable/disable the antialiasing near the boundary\n" +
 	"Press R to go back to the original view\n" +
 	"Press S to take a screenshot of the current view\n" +
 	"Press H to hide/show the information panels\n" +
@@ -42,6 +50,42 @@ namespace {
 	
 	static const sf::Color lightBlue(85, 157, 254);
 	static const sf::Color transparentGrey(30, 30, 30, 180);
+	
+	std::string precisionName(Precision precision)
+	{
+		switch (precision) {
+			case SinglePrecision:	return "float";
+			case DoublePrecision:	return "double";
+			case DoubleDoublePrecision:	return "double-double";
+			case QuadDoublePrecision:	return "quad-double";
+			case PerturbationPrecision:	return "perturbation";
+			case ExtendedPerturbationPrecision:	return "perturbation, floatexp";
+			default:				return "";
+		}
+	}
+	
+	std::string coloringName(Coloring coloring)
+	{
+		switch (coloring) {
+			case IterationColoring:	return "iterations";
+			case SmoothColoring:	return "smooth";
+			case OrbitTrapColoring:	return "orbit trap";
+			case LightingColoring:	return "lighting";
+			case DistanceColoring:	return "distance";
+			default:				return "";
+		}
+	}
+	
+	std::string renderingModeName(RenderingMode mode)
+	{
+		switch (mode) {
+			case PerPixelRendering:			return "per pixel";
+			case SubdivisionRendering:		return "subdivision";
+			case BoundaryTracingRendering:	return "boundary tracing";
+			case SolidGuessingRendering:	return "solid guessing";
+			default:						return "";
+		}
+	}
 }
 
 template <typename T>
@@ -98,10 +142,11 @@ m_panelsAreVisible(true)
 	perfPos.y -= 15;
 	m_performancesInfoShape.setPosition(perfPos);
 	
-	int zoom_stat = m_fractalRenderer.getZoom();
+	FloatExp zoom_stat = m_fractalRenderer.getZoom();
 	int resolution_stat = m_fractalRenderer.getResolution();
-	double xpos_stat = m_fractalRenderer.getNormalizedPosition().x;
-	double ypos_stat = m_fractalRenderer.getNormalizedPosition().y;
+	double xpos_stat = m_fractalRenderer.getCenter().x.toDouble();
+	double ypos_stat = m_fractalRenderer.getCenter().y.toDouble();
+	double rotation_stat = m_fractalRenderer.getRotation();
 	m_fractalInfoText.setCharacterSize(18);
 	m_fractalInfoText.setStyle(sf::Text::Regular);
 	m_fractalInfoText.setFont(m_textFont);
@@ -109,7 +154,9 @@ m_panelsAreVisible(true)
 	m_fractalInfoText.setString(std::string("Rendering parameters\n") +
 								"Zoom: x" + ftostr(zoom_stat) + "\n" +
 								"Precision level: " + ftostr(resolution_stat) + "\n" +
-								"Position: " + ftostr(xpos_stat) + " ; " + ftostr(ypos_stat));
+								"Position: " + ftostr(xpos_stat) + " ; " + ftostr(ypos_stat) + "\n" +
+								"Rotation: " + ftostr(rotation_stat) + " degrees\n" +
+								"Coloring: " + coloringName(m_fractalRenderer.getColoring()));
 	m_fractalInfoText.setPosition(10, m_window.getSize().y - m_fractalInfoText.getLocalBounds().height - 10);
 	
 	sf::Vector2f finfoSize = sf::Vector2f(m_fractalInfoText.getGlobalBounds().width + 25,
@@ -131,6 +178,14 @@ m_panelsAreVisible(true)
 	m_actionsTable["zoom out"] = thor::Action(sf::Keyboard::M, thor::Action::PressOnce);
 	m_actionsTable["increase resolution"] = thor::Action(sf::Keyboard::O, thor::Action::PressOnce);
 	m_actionsTable["decrease resolution"] = thor::Action(sf::Keyboard::L, thor::Action::PressOnce);
+	m_actionsTable["toggle periodicity checking"] = thor::Action(sf::Keyboard::C, thor::Action::PressOnce);
+	m_actionsTable["toggle interior proof"] = thor::Action(sf::Keyboard::I, thor::Action::PressOnce);
+	m_actionsTable["rotate left"] = thor::Action(sf::Keyboard::A, thor::Action::PressOnce);
+	m_actionsTable["rotate right"] = thor::Action(sf::Keyboard::Z, thor::Action::PressOnce);
+	m_actionsTable["change coloring"] = thor::Action(sf::Keyboard::V, thor::Action::PressOnce);
+	m_actionsTable["change rendering mode"] = thor::Action(sf::Keyboard::G, thor::Action::PressOnce);
+	m_actionsTable["toggle guess verification"] = thor::Action(sf::Keyboard::K, thor::Action::PressOnce);
+	m_actionsTable["toggle antialiasing"] = thor::Action(sf::Keyboard::X, thor::Action::PressOnce);
 	
 	m_actionsTable["move left"] = thor::Action(sf::Keyboard::Left, thor::Action::PressOnce);
 	m_actionsTable["move up"] = thor::Action(sf::Keyboard::Up, thor::Action::PressOnce);
@@ -147,6 +202,14 @@ m_panelsAreVisible(true)
 	m_callbackSystem.connect("zoom out", std::bind(&Application::zoomOut, this));
 	m_callbackSystem.connect("increase resolution", std::bind(&Application::increaseResolution, this));
 	m_callbackSystem.connect("decrease resolution", std::bind(&Application::decreaseResolution, this));
+	m_callbackSystem.connect("toggle periodicity checking", std::bind(&Application::togglePeriodicityChecking, this));
+	m_callbackSystem.connect("toggle interior proof", std::bind(&Application::toggleInteriorProof, this));
+	m_callbackSystem.connect("rotate left", std::bind(&Application::rotate, this, 15.0));
+	m_callbackSystem.connect("rotate right", std::bind(&Application::rotate, this, -15.0));
+	m_callbackSystem.connect("change coloring", std::bind(&Application::changeColoring, this));
+	m_callbackSystem.connect("change rendering mode", std::bind(&Application::changeRenderingMode, this));
+	m_callbackSystem.connect("toggle guess verification", std::bind(&Application::toggleGuessVerification, this));
+	m_callbackSystem.connect("toggle antialiasing", std::bind(&Application::toggleAntialiasing, this));
 	
 	m_callbackSystem.connect("move left", std::bind(&Application::move, this, Left));
 	m_callbackSystem.connect("move up", std::bind(&Application::move, this, Up));
@@ -169,7 +232,15 @@ void Application::handleEvents(void)
 
 void Application::update(void)
 {
-	m_performancesInfoText.setString("Fractal rendered in " + ftostr(m_fractalRenderer.getLastRenderingTime().asMilliseconds()) +" ms");
+	m_performancesInfoText.setString("Fractal rendered in " + ftostr(m_fractalRenderer.getLastRenderingTime().asMilliseconds()) +" ms" +
+									 " (" + KernelRegistry::getSelected().name + " kernel, " +
+									 precisionName(m_fractalRenderer.getPrecision()) + ", " +
+									 renderingModeName(m_fractalRenderer.getRenderingMode()) +
+									 (m_fractalRenderer.getRenderingMode() == SolidGuessingRendering &&
+									  m_fractalRenderer.getGuessVerification() ? " verified" : "") +
+									 (m_fractalRenderer.getSupersampling() > 1 ? ", antialiased" : "") +
+									 (m_fractalRenderer.getInteriorProof() ? ", interior proof" : "") +
+									 (m_fractalRenderer.getPeriodicityChecking() ? ", periodicity checking)" : ")"));
 	m_performancesInfoText.setPosition(m_window.getSize().x - m_performancesInfoText.getLocalBounds().width - 10, 10);
 	
 	sf::Vector2f perfPos = m_performancesInfoText.getPosition();
@@ -191,14 +262,17 @@ void Application::update(void)
 	
 	m_fractalSprite.setTexture(m_fractalRenderer.getTexture());
 	
-	double zoom_stat = m_fractalRenderer.getZoom();
+	FloatExp zoom_stat = m_fractalRenderer.getZoom();
 	int resolution_stat = m_fractalRenderer.getResolution();
-	double xpos_stat = m_fractalRenderer.getNormalizedPosition().x;
-	double ypos_stat = m_fractalRenderer.getNormalizedPosition().y;
+	double xpos_stat = m_fractalRenderer.getCenter().x.toDouble();
+	double ypos_stat = m_fractalRenderer.getCenter().y.toDouble();
+	double rotation_stat = m_fractalRenderer.getRotation();
 	m_fractalInfoText.setString(std::string("Rendering parameters\n") +
 								"Zoom: x" + ftostr(zoom_stat) + "\n" +
 								"Precision level: " + ftostr(resolution_stat) + "\n" +
-								"Position: " + ftostr(xpos_stat) + " ; " + ftostr(ypos_stat));
+								"Position: " + ftostr(xpos_stat) + " ; " + ftostr(ypos_stat) + "\n" +
+								"Rotation: " + ftostr(rotation_stat) + " degrees\n" +
+								"Coloring: " + coloringName(m_fractalRenderer.getColoring()));
 }
 
 void Application::draw(void)
@@ -226,7 +300,8 @@ void Application::terminate(void)
 
 void Application::resetView(void)
 {
-	m_fractalRenderer.setNormalizedPosition(Vector2lf(0.4, 0.5));
+	m_fractalRenderer.setCenter(Vector2bf(-0.75, 0));
+	m_fractalRenderer.setRotation(0);
 	m_fractalRenderer.setResolution(30);
 	m_fractalRenderer.setZoom(1.0);
 	m_fractalRenderer.performRendering();
@@ -251,7 +326,7 @@ void Application::togglePanels(void)
 
 void Application::zoomIn(void)
 {
-	double zoom = m_fractalRenderer.getZoom();
+	FloatExp zoom = m_fractalRenderer.getZoom();
 	
 	m_fractalRenderer.setZoom(zoom * 1.3);
 	m_fractalRenderer.performRendering();
@@ -259,7 +334,7 @@ void Application::zoomIn(void)
 
 void Application::zoomOut(void)
 {
-	double zoom = m_fractalRenderer.getZoom();
+	FloatExp zoom = m_fractalRenderer.getZoom();
 	
 	m_fractalRenderer.setZoom(zoom * 1/1.3);
 	m_fractalRenderer.performRendering();
@@ -292,21 +367,71 @@ void Application::decreaseResolution(void)
 	m_fractalRenderer.performRendering();
 }
 
+void Application::togglePeriodicityChecking(void)
+{
+	m_fractalRenderer.setPeriodicityChecking(!m_fractalRenderer.getPeriodicityChecking());
+	m_fractalRenderer.performRendering();
+}
+
+void Application::toggleInteriorProof(void)
+{
+	m_fractalRenderer.setInteriorProof(!m_fractalRenderer.getInteriorProof());
+	m_fractalRenderer.performRendering();
+}
+
+void Application::changeColoring(void)
+{
+	Coloring next = (Coloring)((m_fractalRenderer.getColoring() + 1) % (DistanceColoring + 1));
+	
+	m_fractalRenderer.setColoring(next);
+	m_fractalRenderer.performRendering();
+}
+
+void Application::changeRenderingMode(void)
+{
+	RenderingMode next = (RenderingMode)((m_fractalRenderer.getRenderingMode() + 1) % (SolidGuessingRendering + 1));
+	
+	m_fractalRenderer.setRenderingMode(next);
+	m_fractalRenderer.performRendering();
+}
+
+void Application::toggleGuessVerification(void)
+{
+	m_fractalRenderer.setGuessVerification(!m_fractalRenderer.getGuessVerification());
+	
+	if (m_fractalRenderer.getRenderingMode() == SolidGuessingRendering)
+		m_fractalRenderer.performRendering();
+}
+
+// Supersampling of the pixels near the boundary, 4 by 4 samples each
+void Application::toggleAntialiasing(void)
+{
+	m_fractalRenderer.setSupersampling(m_fractalRenderer.getSupersampling() > 1 ? 1 : 4);
+	m_fractalRenderer.performRendering();
+}
+
+void Application::rotate(double angle)
+{
+	m_fractalRenderer.setRotation(m_fractalRenderer.getRotation() + angle);
+	m_fractalRenderer.performRendering();
+}
+
 void Application::move(Direction aDirection)
 {
-	Vector2lf position = m_fractalRenderer.getNormalizedPosition();
-	double zoom = m_fractalRenderer.getZoom();
-	double offset = .1 / zoom;
+	// A tenth of the window, whatever the zoom and the rotation
+	Vector2lf translation;
+	double offset_x = m_window.getSize().x * .1;
+	double offset_y = m_window.getSize().y * .1;
 	
 	switch (aDirection) {
-		case Left:	position.x -= offset;	break;
-		case Right:	position.x += offset;	break;
-		case Up:	position.y -= offset;	break;
-		case Down:	position.y += offset;	break;
+		case Left:	translation.x -= offset_x;	break;
+		case Right:	translation.x += offset_x;	break;
+		case Up:	translation.y -= offset_y;	break;
+		case Down:	translation.y += offset_y;	break;
 		default:	break;
 	}
 	
-	m_fractalRenderer.setNormalizedPosition(position);
+	m_fractalRenderer.moveView(translation);
 	m_fractalRenderer.performRendering();
 }
 
@@ -76,6 +76,13 @@ private:
 	void zoomOut(void);
 	void increaseResolution(void);
 	void decreaseResolution(void);
+	void togglePeriodicityChecking(void);
+	void toggleInteriorProof(void);
+	void changeColoring(void);
+	void changeRenderingMode(void);
+	void toggleGuessVerification(void);
+	void toggleAntialiasing(void);
+	void rotate(double angle);
 	void move(Direction aDirection);
 };
 
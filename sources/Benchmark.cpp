@@ -0,0 +1,131 @@
+
+/*
+ *  Benchmark.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "MandelbrotRenderer.hpp"
+#include "KernelRegistry.hpp"
+#include <tbb/parallel_for.h>
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+	const unsigned width = 640;
+	const unsigned height = 400;
+	const int resolution = 1000;
+	
+	// From the start to the end of the double-double range, centered on i,
+	// which is on the boundary of the set and has details at every zoom
+	const double zooms[] = {1e15, 1e21, 1e27};
+	const double center_r = 0;
+	const double center_i = 1;
+	
+	// FNV-1a
+	uint64_t checksum(const std::vector<unsigned char>& pixels)
+	{
+		uint64_t hash = UINT64_C(14695981039346656037);
+		
+		for (unsigned i = 0; i < pixels.size(); i++)
+			hash = (hash ^ pixels[i]) * UINT64_C(1099511628211);
+		
+		return hash;
+	}
+	
+	unsigned countDifferences(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b)
+	{
+		unsigned count = 0;
+		
+		for (unsigned i = 0; i < a.size(); i += 4)
+		{
+			if (a[i] != b[i] || a[i + 1] != b[i + 1] || a[i + 2] != b[i + 2])
+				count++;
+		}
+		
+		return count;
+	}
+	
+	// Renders the view and returns the time it took
+	sf::Time render(std::vector<unsigned char>& pixels, const Viewport& viewport,
+					const KernelRegistry::Entry& kernels, Precision precision, bool periodicityChecking)
+	{
+		sf::Clock timer;
+		MandelbrotRenderer renderer(&pixels[0], viewport, resolution, kernels);
+		renderer.setPrecision(precision);
+		renderer.setPeriodicityChecking(periodicityChecking);
+		tbb::parallel_for(tbb::blocked_range2d<unsigned, unsigned>(0, width, 50, 0, height, 50), renderer);
+		return timer.getElapsedTime();
+	}
+	
+	void printResult(const std::string& name, sf::Time time, const std::vector<unsigned char>& pixels,
+					 const std::vector<unsigned char>& reference)
+	{
+		std::cout << "  " << std::left << std::setw(22) << name << std::right
+		<< std::setw(8) << time.asMilliseconds() << " ms   checksum "
+		<< std::hex << std::setw(16) << std::setfill('0') << checksum(pixels)
+		<< std::dec << std::setfill(' ') << "   "
+		<< countDifferences(pixels, reference) << " pixels differ" << std::endl;
+	}
+}
+
+int runBenchmark(void)
+{
+	Viewport viewport(width, height);
+	viewport.setCenter(Vector2bf(center_r, center_i));
+	
+	std::cout << width << "x" << height << " pixels, " << resolution << " iterations" << std::endl;
+	
+	for (unsigned z = 0; z < sizeof(zooms) / sizeof(zooms[0]); z++)
+	{
+		std::vector<unsigned char> reference(width * height * 4);
+		std::vector<unsigned char> pixels(width * height * 4);
+		viewport.setZoom(zooms[z]);
+		
+		sf::Time time = render(reference, viewport, KernelRegistry::getEntry(0), QuadDoublePrecision, false);
+		
+		std::cout << "zoom " << zooms[z] << std::endl;
+		printResult("quad-double", time, reference, reference);
+		
+		for (unsigned i = 0; i < KernelRegistry::getEntryCount(); i++)
+		{
+			const KernelRegistry::Entry& entry = KernelRegistry::getEntry(i);
+			
+			if (!entry.isSupported())
+				continue;
+			
+			time = render(pixels, viewport, entry, DoubleDoublePrecision, false);
+			printResult(entry.name, time, pixels, reference);
+			
+			time = render(pixels, viewport, entry, DoubleDoublePrecision, true);
+			printResult(std::string(entry.name) + ", periodicity", time, pixels, reference);
+		}
+	}
+	
+	return 0;
+}
@@ -0,0 +1,38 @@
+
+/*
+ *  Benchmark.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+// Renders a few views of the double-double range with every kernel variant
+// the host supports, with and without periodicity checking, and with
+// quad-doubles as the reference, then prints
+// the rendering times, a checksum of each image, and how many pixels differ
+// from the reference. Returns the exit code of the program.
+int runBenchmark(void);
+
+#endif
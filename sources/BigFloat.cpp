@@ -0,0 +1,200 @@
+
+/*
+ *  BigFloat.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "BigFloat.hpp"
+
+namespace BigFloatDetail {
+	namespace {
+		void multiplySchoolbook(const uint32_t *a, const uint32_t *b, unsigned n, uint32_t *product)
+		{
+			for (unsigned i = 0; i < 2 * n; i++)
+				product[i] = 0;
+			
+			for (unsigned i = 0; i < n; i++)
+			{
+				uint64_t carry = 0;
+				
+				for (unsigned j = 0; j < n; j++)
+				{
+					uint64_t t = (uint64_t)a[i] * b[j] + product[i + j] + carry;
+					product[i + j] = (uint32_t)t;
+					carry = t >> 32;
+				}
+				
+				product[i + n] = (uint32_t)carry;
+			}
+		}
+		
+		// Adds or subtracts 'b' to the first 'count' limbs of 'a' and propagates
+		// the carry up to limb 'length' of 'a'
+		void addPropagating(uint32_t *a, unsigned length, const uint32_t *b, unsigned count)
+		{
+			uint32_t carry = addTo(a, b, count);
+			
+			for (unsigned i = count; carry && i < length; i++)
+				carry = (++a[i] == 0);
+		}
+		
+		void subtractPropagating(uint32_t *a, unsigned length, const uint32_t *b, unsigned count)
+		{
+			uint32_t borrow = subtractFrom(a, b, count);
+			
+			for (unsigned i = count; borrow && i < length; i++)
+				borrow = (a[i]-- == 0);
+		}
+	}
+	
+	void multiply(const uint32_t *a, const uint32_t *b, unsigned n, uint32_t *product, uint32_t *scratch)
+	{
+		if (n < karatsubaThreshold)
+		{
+			multiplySchoolbook(a, b, n, product);
+			return;
+		}
+		
+		// a = a1 * B^h + a0 and b = b1 * B^h + b0, then
+		// a * b = z2 * B^2h + ((a0 + a1) * (b0 + b1) - z2 - z0) * B^h + z0
+		unsigned h = n / 2;
+		unsigned m = n - h;
+		
+		uint32_t *sumA = scratch;
+		uint32_t *sumB = sumA + (m + 1);
+		uint32_t *middle = sumB + (m + 1);
+		uint32_t *next = middle + 2 * (m + 1);
+		
+		multiply(a, b, h, product, next);
+		multiply(a + h, b + h, m, product + 2 * h, next);
+		
+		for (unsigned i = 0; i < m; i++)
+		{
+			sumA[i] = a[h + i];
+			sumB[i] = b[h + i];
+		}
+		
+		sumA[m] = sumB[m] = 0;
+		addPropagating(sumA, m + 1, a, h);
+		addPropagating(sumB, m + 1, b, h);
+		
+		multiply(sumA, sumB, m + 1, middle, next);
+		subtractPropagating(middle, 2 * (m + 1), product, 2 * h);
+		subtractPropagating(middle, 2 * (m + 1), product + 2 * h, 2 * m);
+		
+		// The middle term is below B^(2m+1) and fits in what is left of the product
+		addPropagating(product + h, 2 * n - h, middle, 2 * m + 1);
+	}
+	
+	uint32_t addTo(uint32_t *a, const uint32_t *b, unsigned count)
+	{
+		uint64_t carry = 0;
+		
+		for (unsigned i = 0; i < count; i++)
+		{
+			carry += (uint64_t)a[i] + b[i];
+			a[i] = (uint32_t)carry;
+			carry >>= 32;
+		}
+		
+		return (uint32_t)carry;
+	}
+	
+	uint32_t subtractFrom(uint32_t *a, const uint32_t *b, unsigned count)
+	{
+		uint32_t borrow = 0;
+		
+		for (unsigned i = 0; i < count; i++)
+		{
+			uint64_t t = (uint64_t)a[i] - b[i] - borrow;
+			a[i] = (uint32_t)t;
+			borrow = (t >> 32) ? 1 : 0;
+		}
+		
+		return borrow;
+	}
+	
+	void shiftRight(uint32_t *a, unsigned count, unsigned bits)
+	{
+		unsigned limbs = bits / 32;
+		bits %= 32;
+		
+		for (unsigned i = 0; i < count; i++)
+		{
+			uint64_t low = (i + limbs < count) ? a[i + limbs] : 0;
+			uint64_t high = (i + limbs + 1 < count) ? a[i + limbs + 1] : 0;
+			a[i] = (uint32_t)(((high << 32) | low) >> bits);
+		}
+	}
+	
+	void shiftLeft(uint32_t *a, unsigned count, unsigned bits)
+	{
+		unsigned limbs = bits / 32;
+		bits %= 32;
+		
+		for (unsigned i = count; i-- > 0;)
+		{
+			uint64_t high = (i >= limbs) ? a[i - limbs] : 0;
+			uint64_t low = (i >= limbs + 1) ? a[i - limbs - 1] : 0;
+			a[i] = (uint32_t)(((high << 32) | low) >> (32 - bits));
+		}
+	}
+	
+	unsigned countLeadingZeros(const uint32_t *a, unsigned count)
+	{
+		unsigned zeros = 0;
+		
+		for (unsigned i = count; i-- > 0;)
+		{
+			uint32_t limb = a[i];
+			
+			if (limb == 0)
+			{
+				zeros += 32;
+				continue;
+			}
+			
+			while ((limb & 0x80000000) == 0)
+			{
+				limb <<= 1;
+				zeros++;
+			}
+			
+			break;
+		}
+		
+		return zeros;
+	}
+	
+	int compare(const uint32_t *a, const uint32_t *b, unsigned count)
+	{
+		for (unsigned i = count; i-- > 0;)
+		{
+			if (a[i] != b[i])
+				return (a[i] > b[i]) ? 1 : -1;
+		}
+		
+		return 0;
+	}
+}
@@ -0,0 +1,347 @@
+
+/*
+ *  BigFloat.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef BIG_FLOAT_HPP
+#define BIG_FLOAT_HPP
+
+#include <cmath>
+#include <cstdint>
+#include "QuadDouble.hpp"
+
+// Operations on magnitudes stored as little-endian arrays of 32 bits limbs
+namespace BigFloatDetail {
+	// Full n x n limbs product. 'scratch' must hold 8 * n + 64 limbs, and
+	// Karatsuba's method is used above karatsubaThreshold limbs.
+	const unsigned karatsubaThreshold = 40;
+	void multiply(const uint32_t *a, const uint32_t *b, unsigned n, uint32_t *product, uint32_t *scratch);
+	
+	// In place operations on 'count' limbs, returning the carry or borrow out
+	uint32_t addTo(uint32_t *a, const uint32_t *b, unsigned count);
+	uint32_t subtractFrom(uint32_t *a, const uint32_t *b, unsigned count);
+	void shiftRight(uint32_t *a, unsigned count, unsigned bits);
+	void shiftLeft(uint32_t *a, unsigned count, unsigned bits);
+	
+	unsigned countLeadingZeros(const uint32_t *a, unsigned count);
+	int compare(const uint32_t *a, const uint32_t *b, unsigned count);
+}
+
+// Binary floating point number with a mantissa of 32 * Limbs bits and a
+// machine int exponent. Everything lives in the object itself, so that
+// computations never allocate: this is what reference orbits are computed
+// with. Results are truncated rather than rounded.
+template <unsigned Limbs>
+class BigFloat {
+	static_assert(Limbs >= 2, "BigFloat needs at least two limbs to hold a double");
+	
+	// value = (-1)^m_negative * m_limbs * 2^(m_exponent - 32 * Limbs), with
+	// the top bit of m_limbs set unless the number is zero
+	uint32_t m_limbs[Limbs];
+	int m_exponent;
+	bool m_negative;
+	
+public:
+	BigFloat(void) :
+	m_exponent(0),
+	m_negative(false)
+	{
+		for (unsigned i = 0; i < Limbs; i++)
+			m_limbs[i] = 0;
+	}
+	
+	BigFloat(double value) :
+	m_exponent(0),
+	m_negative(value < 0)
+	{
+		for (unsigned i = 0; i < Limbs; i++)
+			m_limbs[i] = 0;
+		
+		if (value != 0)
+		{
+			uint64_t mantissa = std::ldexp(std::frexp(std::fabs(value), &m_exponent), 64);
+			m_limbs[Limbs - 1] = mantissa >> 32;
+			m_limbs[Limbs - 2] = (uint32_t)mantissa;
+		}
+	}
+	
+	// Conversion between precisions, truncating when narrowing
+	template <unsigned OtherLimbs>
+	explicit BigFloat(const BigFloat<OtherLimbs>& other) :
+	m_exponent(other.m_exponent),
+	m_negative(other.m_negative)
+	{
+		for (unsigned i = 0; i < Limbs; i++)
+			m_limbs[Limbs - 1 - i] = (i < OtherLimbs) ? other.m_limbs[OtherLimbs - 1 - i] : 0;
+	}
+	
+	bool isZero(void) const
+	{
+		return m_limbs[Limbs - 1] == 0;
+	}
+	
+	bool isNegative(void) const
+	{
+		return m_negative && !isZero();
+	}
+	
+	int getExponent(void) const
+	{
+		return m_exponent;
+	}
+	
+	double toDouble(void) const
+	{
+		if (isZero())
+			return 0;
+		
+		uint64_t top = ((uint64_t)m_limbs[Limbs - 1] << 32) | m_limbs[Limbs - 2];
+		double value = std::ldexp((double)top, m_exponent - 64);
+		return m_negative ? -value : value;
+	}
+	
+	QuadDouble toQuadDouble(void) const
+	{
+		BigFloat rest = *this;
+		double parts[4];
+		
+		for (unsigned i = 0; i < 4; i++)
+		{
+			parts[i] = rest.toDouble();
+			rest = rest - BigFloat(parts[i]);
+		}
+		
+		return QuadDoubleDetail::renormalize(parts[0], parts[1], parts[2], parts[3], rest.toDouble());
+	}
+	
+	DoubleDouble toDoubleDouble(void) const
+	{
+		double hi = toDouble();
+		return quickTwoSum(hi, (*this - BigFloat(hi)).toDouble());
+	}
+	
+	BigFloat operator-(void) const
+	{
+		BigFloat result = *this;
+		result.m_negative = !m_negative;
+		return result;
+	}
+	
+	BigFloat operator+(const BigFloat& other) const
+	{
+		if (isZero())
+			return other;
+		
+		if (other.isZero())
+			return *this;
+		
+		if (m_negative == other.m_negative)
+			return addMagnitudes(*this, other);
+		
+		if (compareMagnitudes(*this, other) >= 0)
+			return subtractMagnitudes(*this, other);
+		
+		return subtractMagnitudes(other, *this);
+	}
+	
+	BigFloat operator-(const BigFloat& other) const
+	{
+		return *this + -other;
+	}
+	
+	BigFloat operator*(const BigFloat& other) const
+	{
+		BigFloat result;
+		
+		if (isZero() || other.isZero())
+			return result;
+		
+		uint32_t product[2 * Limbs];
+		uint32_t scratch[8 * Limbs + 64];
+		BigFloatDetail::multiply(m_limbs, other.m_limbs, Limbs, product, scratch);
+		
+		// Both mantissas are in [1/2, 1[ so at most one bit needs to be
+		// shifted back in
+		result.m_exponent = m_exponent + other.m_exponent;
+		
+		if ((product[2 * Limbs - 1] & 0x80000000) == 0)
+		{
+			BigFloatDetail::shiftLeft(product, 2 * Limbs, 1);
+			result.m_exponent--;
+		}
+		
+		for (unsigned i = 0; i < Limbs; i++)
+			result.m_limbs[i] = product[Limbs + i];
+		
+		result.m_negative = m_negative != other.m_negative;
+		return result;
+	}
+	
+	BigFloat& operator+=(const BigFloat& other)
+	{
+		return *this = *this + other;
+	}
+	
+	BigFloat& operator-=(const BigFloat& other)
+	{
+		return *this = *this - other;
+	}
+	
+	BigFloat& operator*=(const BigFloat& other)
+	{
+		return *this = *this * other;
+	}
+	
+	BigFloat operator/(const BigFloat& other) const
+	{
+		return *this * reciprocal(other);
+	}
+	
+	// Newton's iteration x' = x + x(1 - vx) from the double reciprocal, each
+	// step doubling the number of correct bits
+	friend BigFloat reciprocal(const BigFloat& value)
+	{
+		BigFloat scaled = ldexp(value, -value.m_exponent);
+		BigFloat x(1 / scaled.toDouble());
+		
+		for (unsigned bits = 48; bits < 32 * Limbs; bits *= 2)
+			x += x * (BigFloat(1.0) - scaled * x);
+		
+		return ldexp(x, -value.m_exponent);
+	}
+	
+	// Multiplication by 2^power, which is exact
+	friend BigFloat ldexp(const BigFloat& value, int power)
+	{
+		BigFloat result = value;
+		
+		if (!result.isZero())
+			result.m_exponent += power;
+		
+		return result;
+	}
+	
+	// Rounding toward zero
+	friend BigFloat trunc(const BigFloat& value)
+	{
+		BigFloat result = value;
+		
+		if (value.m_exponent <= 0)
+			return BigFloat();
+		
+		if (value.m_exponent >= (int)(32 * Limbs))
+			return result;
+		
+		unsigned fractionBits = 32 * Limbs - value.m_exponent;
+		
+		for (unsigned i = 0; i < fractionBits / 32; i++)
+			result.m_limbs[i] = 0;
+		
+		if (fractionBits % 32)
+			result.m_limbs[fractionBits / 32] &= ~((1u << (fractionBits % 32)) - 1);
+		
+		return result;
+	}
+	
+private:
+	template <unsigned> friend class BigFloat;
+	
+	static int compareMagnitudes(const BigFloat& a, const BigFloat& b)
+	{
+		if (a.m_exponent != b.m_exponent)
+			return (a.m_exponent > b.m_exponent) ? 1 : -1;
+		
+		return BigFloatDetail::compare(a.m_limbs, b.m_limbs, Limbs);
+	}
+	
+	// Copies the mantissa of 'b' aligned on the exponent of 'a', with one
+	// extra guard limb at index 0
+	static void align(const BigFloat& a, const BigFloat& b, uint32_t *aligned)
+	{
+		unsigned shift = a.m_exponent - b.m_exponent;
+		aligned[0] = 0;
+		
+		for (unsigned i = 0; i < Limbs; i++)
+			aligned[i + 1] = b.m_limbs[i];
+		
+		BigFloatDetail::shiftRight(aligned, Limbs + 1, shift);
+	}
+	
+	static BigFloat addMagnitudes(const BigFloat& a, const BigFloat& b)
+	{
+		if (a.m_exponent < b.m_exponent)
+			return addMagnitudes(b, a);
+		
+		uint32_t sum[Limbs + 1];
+		align(a, b, sum);
+		
+		BigFloat result = a;
+		uint32_t carry = BigFloatDetail::addTo(sum + 1, a.m_limbs, Limbs);
+		
+		if (carry)
+		{
+			BigFloatDetail::shiftRight(sum, Limbs + 1, 1);
+			sum[Limbs] |= 0x80000000;
+			result.m_exponent++;
+		}
+		
+		for (unsigned i = 0; i < Limbs; i++)
+			result.m_limbs[i] = sum[i + 1];
+		
+		return result;
+	}
+	
+	// |a| - |b| with the sign of a, for |a| >= |b|
+	static BigFloat subtractMagnitudes(const BigFloat& a, const BigFloat& b)
+	{
+		uint32_t difference[Limbs + 1];
+		uint32_t subtrahend[Limbs + 1];
+		align(a, b, subtrahend);
+		
+		difference[0] = 0;
+		
+		for (unsigned i = 0; i < Limbs; i++)
+			difference[i + 1] = a.m_limbs[i];
+		
+		BigFloatDetail::subtractFrom(difference, subtrahend, Limbs + 1);
+		
+		BigFloat result;
+		unsigned zeros = BigFloatDetail::countLeadingZeros(difference, Limbs + 1);
+		
+		if (zeros == 32 * (Limbs + 1))
+			return result;
+		
+		BigFloatDetail::shiftLeft(difference, Limbs + 1, zeros);
+		
+		for (unsigned i = 0; i < Limbs; i++)
+			result.m_limbs[i] = difference[i + 1];
+		
+		result.m_exponent = a.m_exponent - zeros;
+		result.m_negative = a.m_negative;
+		return result;
+	}
+};
+
+#endif
@@ -0,0 +1,90 @@
+
+/*
+ *  BilinearApproximation.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "BilinearApproximation.hpp"
+#include <algorithm>
+
+BilinearApproximation::BilinearApproximation(void) :
+m_levels()
+{
+}
+
+
+void BilinearApproximation::compute(const ReferenceOrbit& referenceOrbit, const FloatExp& maxOffset, int maxIterations)
+{
+	// Dropping d^2 at each step has to stay below double rounding errors
+	const double epsilon = std::ldexp(1.0, -53);
+	const double *Z_r = referenceOrbit.getRealParts();
+	const double *Z_i = referenceOrbit.getImaginaryParts();
+	int length = std::min<int>(maxIterations, referenceOrbit.getLength() - 1);
+	
+	m_levels.clear();
+	
+	if (length < 2)
+		return;
+	
+	// Single steps d' = 2Z d + dc, valid while |d|^2 is negligible against |2Z d|
+	m_levels.push_back(std::vector<Step>(length));
+	
+	for (int n = 0; n < length; n++)
+	{
+		Step& step = m_levels[0][n];
+		step.a_r = 2 * Z_r[n];
+		step.a_i = 2 * Z_i[n];
+		step.b_r = 1;
+		step.b_i = 0;
+		step.radius = epsilon * std::hypot(step.a_r, step.a_i);
+	}
+	
+	// Each level merges two consecutive steps x then y of the previous one:
+	// A = Ay Ax, B = Ay Bx + By, and d must be valid for x and then, once
+	// moved by x, for y
+	while (m_levels.back().size() >= 2)
+	{
+		const std::vector<Step>& previous = m_levels.back();
+		std::vector<Step> merged(previous.size() / 2);
+		
+		for (unsigned n = 0; n < merged.size(); n++)
+		{
+			const Step& x = previous[2 * n];
+			const Step& y = previous[2 * n + 1];
+			Step& step = merged[n];
+			
+			step.a_r = y.a_r * x.a_r - y.a_i * x.a_i;
+			step.a_i = y.a_r * x.a_i + y.a_i * x.a_r;
+			step.b_r = y.a_r * x.b_r - y.a_i * x.b_i + y.b_r;
+			step.b_i = y.a_r * x.b_i + y.a_i * x.b_r + y.b_i;
+			
+			double a = std::hypot(x.a_r, x.a_i);
+			double b = std::hypot(x.b_r, x.b_i);
+			double radius = (a > 0) ? (y.radius - (b * maxOffset).toDouble()) / a : 0;
+			step.radius = std::max(0.0, std::min(x.radius, radius));
+		}
+		
+		m_levels.push_back(merged);
+	}
+}
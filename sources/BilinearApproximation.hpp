@@ -0,0 +1,104 @@
+
+/*
+ *  BilinearApproximation.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef BILINEAR_APPROXIMATION_HPP
+#define BILINEAR_APPROXIMATION_HPP
+
+#include <cmath>
+#include <vector>
+#include "ReferenceOrbit.hpp"
+#include "FloatExp.hpp"
+
+// While the offset d from the reference orbit is small enough, 2^k
+// perturbation steps starting at an iteration multiple of 2^k boil down to
+// d' = A d + B dc. The table holds, for each level k, these coefficients
+// and the radius within which |d| must be for the approximation to hold.
+class BilinearApproximation {
+public:
+	struct Step {
+		double a_r;
+		double a_i;
+		double b_r;
+		double b_i;
+		double radius;
+	};
+	
+	BilinearApproximation(void);
+	
+	// 'maxOffset' is the largest |dc| the table will be used with
+	void compute(const ReferenceOrbit& referenceOrbit, const FloatExp& maxOffset, int maxIterations);
+	
+	// Jumps as many iterations as possible from 'iteration', without going
+	// past 'limit', and returns false if not even a single step is valid.
+	// Offsets are either doubles or floatexps.
+	template <typename Real>
+	bool jump(int& iteration, Real& d_r, Real& d_i, const Real& dc_r, const Real& dc_i, int limit) const
+	{
+		using std::fabs;
+		
+		if (iteration == 0)
+			return false;
+		
+		// Any norm works to compare with the radii, and this one cannot
+		// underflow at deep zooms
+		Real offset = fabs(d_r) + fabs(d_i);
+		const Step *best = NULL;
+		int bestSteps = 0;
+		
+		// A merged step is never valid further than the first of the steps it
+		// merges, so the search can stop at the first level that fails
+		for (unsigned level = 0; level < m_levels.size(); level++)
+		{
+			int steps = 1 << level;
+			
+			if ((iteration & (steps - 1)) != 0 || iteration + steps > limit)
+				break;
+			
+			const Step& step = m_levels[level][iteration >> level];
+			
+			if (!(offset < step.radius))
+				break;
+			
+			best = &step;
+			bestSteps = steps;
+		}
+		
+		if (best == NULL)
+			return false;
+		
+		Real tmp = d_r;
+		d_r = best->a_r * d_r - best->a_i * d_i + best->b_r * dc_r - best->b_i * dc_i;
+		d_i = best->a_r * d_i + best->a_i * tmp + best->b_r * dc_i + best->b_i * dc_r;
+		iteration += bestSteps;
+		return true;
+	}
+	
+private:
+	std::vector<std::vector<Step> > m_levels;
+};
+
+#endif
@@ -0,0 +1,294 @@
+
+/*
+ *  BoundaryTracing.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "BoundaryTracing.hpp"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+	// Rows between two seams. The seams are computed in full, so that thinner
+	// strips give more parallelism but guess less.
+	const unsigned stripHeight = 50;
+	
+	enum PixelState {
+		Unknown = 0,
+		Computed = 1,
+		Queued = 2
+	};
+	
+	// Tracing state of a strip, seams included, whose pixels are indexed from
+	// its top left pixel
+	class Strip {
+	public:
+		Strip(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+			  unsigned width, unsigned top, unsigned bottom) :
+		m_renderer(renderer),
+		m_pixelBuffer(pixelBuffer + top * width * 4),
+		m_iterations(iterations + top * width),
+		m_width(width),
+		m_height(bottom - top + 1),
+		m_top(top),
+		m_states(width * (bottom - top + 1), Unknown)
+		{
+			std::fill(m_states.begin(), m_states.begin() + width, Computed);
+			std::fill(m_states.end() - width, m_states.end(), Computed);
+		}
+		
+		void trace(void)
+		{
+			std::vector<unsigned> batch;
+			
+			for (unsigned x = 0; x < m_width; x++)
+			{
+				enqueue(x);
+				enqueue((m_height - 1) * m_width + x);
+			}
+			
+			for (unsigned y = 1; y + 1 < m_height; y++)
+			{
+				enqueue(y * m_width);
+				enqueue(y * m_width + m_width - 1);
+			}
+			
+			// The queue is handled a whole generation at a time, so that its
+			// pixels and their neighbours can be computed together, in a
+			// single kernel run per row
+			while (!m_queue.empty())
+			{
+				batch.swap(m_queue);
+				m_queue.clear();
+				
+				for (unsigned i = 0; i < batch.size(); i++)
+				{
+					unsigned pixel = batch[i];
+					unsigned x = pixel % m_width;
+					unsigned y = pixel / m_width;
+					
+					request(pixel);
+					
+					if (x > 0)				request(pixel - 1);
+					if (x + 1 < m_width)	request(pixel + 1);
+					if (y > 0)				request(pixel - m_width);
+					if (y + 1 < m_height)	request(pixel + m_width);
+				}
+				
+				computeRequested();
+				
+				for (unsigned i = 0; i < batch.size(); i++)
+					examine(batch[i]);
+			}
+			
+			fill();
+		}
+		
+	private:
+		const MandelbrotRenderer& m_renderer;
+		unsigned char *m_pixelBuffer;
+		int *m_iterations;
+		unsigned m_width;
+		unsigned m_height;
+		unsigned m_top;
+		std::vector<unsigned char> m_states;
+		std::vector<unsigned> m_queue;
+		std::vector<unsigned> m_requested;
+		
+		void enqueue(unsigned pixel)
+		{
+			if (!(m_states[pixel] & Queued))
+			{
+				m_states[pixel] |= Queued;
+				m_queue.push_back(pixel);
+			}
+		}
+		
+		void request(unsigned pixel)
+		{
+			if (!(m_states[pixel] & Computed))
+			{
+				m_states[pixel] |= Computed;
+				m_requested.push_back(pixel);
+			}
+		}
+		
+		void computeRequested(void)
+		{
+			std::vector<unsigned> columns;
+			
+			std::sort(m_requested.begin(), m_requested.end());
+			
+			for (unsigned i = 0; i < m_requested.size(); i++)
+			{
+				unsigned y = m_requested[i] / m_width;
+				columns.push_back(m_requested[i] % m_width);
+				
+				if (i + 1 == m_requested.size() || m_requested[i + 1] / m_width != y)
+				{
+					m_renderer.renderPixels(m_top + y, columns);
+					columns.clear();
+				}
+			}
+			
+			m_requested.clear();
+		}
+		
+		// Once a pixel differs from a neighbour, it lies on a boundary which
+		// goes on through the neighbours around it
+		void examine(unsigned pixel)
+		{
+			unsigned x = pixel % m_width;
+			unsigned y = pixel / m_width;
+			bool hasLeft = x > 0;
+			bool hasRight = x + 1 < m_width;
+			bool hasUp = y > 0;
+			bool hasDown = y + 1 < m_height;
+			bool left = hasLeft && !isSame(pixel, pixel - 1);
+			bool right = hasRight && !isSame(pixel, pixel + 1);
+			bool up = hasUp && !isSame(pixel, pixel - m_width);
+			bool down = hasDown && !isSame(pixel, pixel + m_width);
+			
+			if (left)	enqueue(pixel - 1);
+			if (right)	enqueue(pixel + 1);
+			if (up)		enqueue(pixel - m_width);
+			if (down)	enqueue(pixel + m_width);
+			
+			if (hasUp && hasLeft && (up || left))		enqueue(pixel - m_width - 1);
+			if (hasUp && hasRight && (up || right))		enqueue(pixel - m_width + 1);
+			if (hasDown && hasLeft && (down || left))	enqueue(pixel + m_width - 1);
+			if (hasDown && hasRight && (down || right))	enqueue(pixel + m_width + 1);
+		}
+		
+		// Pixels of the same count get the same color, except with the
+		// colorings computed from more than the count, where only the inside
+		// of the set can be guessed
+		bool isSame(unsigned pixel, unsigned neighbour) const
+		{
+			int count = m_iterations[pixel];
+			
+			if (m_iterations[neighbour] != count)
+				return false;
+			
+			return m_renderer.isColoredByIterations() || count == m_renderer.getResolution();
+		}
+		
+		// The left column is part of the edge, so that every pixel left has a
+		// computed or guessed left neighbour
+		void fill(void)
+		{
+			for (unsigned y = 0; y < m_height; y++)
+			{
+				for (unsigned x = 1; x < m_width; x++)
+				{
+					unsigned pixel = y * m_width + x;
+					
+					if (!(m_states[pixel] & Computed))
+					{
+						m_iterations[pixel] = m_iterations[pixel - 1];
+						std::memcpy(m_pixelBuffer + pixel * 4, m_pixelBuffer + (pixel - 1) * 4, 4);
+					}
+				}
+			}
+		}
+	};
+	
+	unsigned getSeam(unsigned index, unsigned top, unsigned bottom)
+	{
+		return std::min(top + index * stripHeight, bottom - 1);
+	}
+	
+	class SeamComputing {
+	public:
+		SeamComputing(const MandelbrotRenderer& renderer, unsigned width, unsigned top, unsigned bottom) :
+		m_renderer(renderer), m_width(width), m_top(top), m_bottom(bottom)
+		{
+		}
+		
+		void operator()(const tbb::blocked_range<unsigned>& seams) const
+		{
+			for (unsigned seam = seams.begin(); seam != seams.end(); seam++)
+			{
+				unsigned row = getSeam(seam, m_top, m_bottom);
+				m_renderer(tbb::blocked_range2d<unsigned, unsigned>(0, m_width, row, row + 1));
+			}
+		}
+		
+	private:
+		const MandelbrotRenderer& m_renderer;
+		unsigned m_width;
+		unsigned m_top;
+		unsigned m_bottom;
+	};
+	
+	class StripTracing {
+	public:
+		StripTracing(const BoundaryTracing& owner, unsigned top, unsigned bottom) :
+		m_owner(owner), m_top(top), m_bottom(bottom)
+		{
+		}
+		
+		void operator()(const tbb::blocked_range<unsigned>& strips) const
+		{
+			for (unsigned strip = strips.begin(); strip != strips.end(); strip++)
+				m_owner.trace(getSeam(strip, m_top, m_bottom), getSeam(strip + 1, m_top, m_bottom));
+		}
+		
+	private:
+		const BoundaryTracing& m_owner;
+		unsigned m_top;
+		unsigned m_bottom;
+	};
+}
+
+BoundaryTracing::BoundaryTracing(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+								 unsigned top, unsigned bottom) :
+m_renderer(renderer),
+m_pixelBuffer(pixelBuffer),
+m_iterations(iterations),
+m_width(renderer.getViewport().getWidth()),
+m_top(top),
+m_bottom(bottom)
+{
+}
+
+
+// The seams are computed first, then shared by the strips on both sides
+// which only read them, so that the strips agree along their seams
+void BoundaryTracing::render(void) const
+{
+	unsigned strips = (m_bottom - m_top - 1 + stripHeight - 1) / stripHeight;
+	
+	tbb::parallel_for(tbb::blocked_range<unsigned>(0, strips + 1, 1), SeamComputing(m_renderer, m_width, m_top, m_bottom));
+	tbb::parallel_for(tbb::blocked_range<unsigned>(0, strips, 1), StripTracing(*this, m_top, m_bottom));
+}
+
+
+void BoundaryTracing::trace(unsigned top, unsigned bottom) const
+{
+	Strip(m_renderer, m_pixelBuffer, m_iterations, m_width, top, bottom).trace();
+}
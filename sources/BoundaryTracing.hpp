@@ -0,0 +1,67 @@
+
+/*
+ *  BoundaryTracing.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *  
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *  
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *  
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *  
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef BOUNDARY_TRACING_HPP
+#define BOUNDARY_TRACING_HPP
+
+#include "MandelbrotRenderer.hpp"
+
+// Boundary tracing. The areas of a given iteration count are connected, so
+// that only the pixels along their boundaries need to be computed: starting
+// from the edges of the image, the neighbours of every pixel whose count
+// differs from one of its own neighbours' are computed in turn, until the
+// boundaries are closed. The pixels left are then given the count of their
+// left neighbour, which belongs to the same area.
+//
+// The image is split into strips traced in parallel, independently of each
+// other. The rows between strips are computed beforehand and taken by the
+// strips on both sides as their edges, so that nothing is left to reconcile
+// along the seams. As with subdivision, a filament thinner than a pixel can
+// be missed when no computed pixel touches it.
+class BoundaryTracing {
+public:
+	// Renders the rows from 'top' to 'bottom', excluded, as a whole image. The
+	// renderer must have been given 'iterations' as its iteration buffer.
+	BoundaryTracing(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+					unsigned top, unsigned bottom);
+	
+	void render(void) const;
+	
+	// Trace the rows from 'top' to 'bottom' as a whole image, both rows
+	// having been computed
+	void trace(unsigned top, unsigned bottom) const;
+	
+private:
+	const MandelbrotRenderer& m_renderer;
+	unsigned char *m_pixelBuffer;
+	int *m_iterations;
+	unsigned m_width;
+	unsigned m_top;
+	unsigned m_bottom;
+};
+
+#endif
@@ -0,0 +1,174 @@
+
+/*
+ *  Colorizers.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *  
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *  
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *  
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *  
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef COLORIZERS_HPP
+#define COLORIZERS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include "EscapeTimeKernels.hpp"
+
+// A colorizer turns what the kernels computed for a pixel into its color.
+// Its Outputs descriptor tells which values besides the iteration count it
+// needs: the renderer is compiled once for each colorizer, with kernels that
+// compute exactly these values and a coloring without any runtime switch.
+// Colorizers giving conjugate points the same color let the renderer mirror
+// the view across the real axis.
+namespace ColorizerDetail {
+	inline void setColor(unsigned char *pixel, double red, double green, double blue)
+	{
+		pixel[0] = red;
+		pixel[1] = green;
+		pixel[2] = blue;
+		pixel[3] = 255;
+	}
+	
+	inline void setInterior(unsigned char *pixel)
+	{
+		setColor(pixel, 0, 54, 76);
+	}
+}
+
+struct IterationColorizer {
+	typedef PixelOutputs<false, false, false> Outputs;
+	static const bool conjugateSymmetric = true;
+	
+	static void color(unsigned char *pixel, const PixelData& data, unsigned index, int resolution)
+	{
+		int iterations = data.iterations[index];
+		
+		if (iterations == resolution)
+			ColorizerDetail::setInterior(pixel);
+		else
+			ColorizerDetail::setColor(pixel, (int)(iterations * 255.0 / resolution), 0, 0);
+	}
+};
+
+// Continuous escape time, from how far past the escape radius z went, which
+// removes the bands of the iteration count
+struct SmoothColorizer {
+	typedef PixelOutputs<true, false, false> Outputs;
+	static const bool conjugateSymmetric = true;
+	
+	static void color(unsigned char *pixel, const PixelData& data, unsigned index, int resolution)
+	{
+		int iterations = data.iterations[index];
+		
+		if (iterations == resolution)
+		{
+			ColorizerDetail::setInterior(pixel);
+			return;
+		}
+		
+		double norm = data.z_r[index] * data.z_r[index] + data.z_i[index] * data.z_i[index];
+		double smooth = iterations + 1 - std::log2(std::log2(norm) / 2);
+		
+		ColorizerDetail::setColor(pixel, std::max(0.0, std::min(255.0, smooth * 255 / resolution)), 0, 0);
+	}
+};
+
+// Orbit trap on the origin: the closer the orbit came to 0, the brighter
+struct OrbitTrapColorizer {
+	typedef PixelOutputs<false, false, true> Outputs;
+	static const bool conjugateSymmetric = true;
+	
+	static void color(unsigned char *pixel, const PixelData& data, unsigned index, int resolution)
+	{
+		if (data.iterations[index] == resolution)
+		{
+			ColorizerDetail::setInterior(pixel);
+			return;
+		}
+		
+		double distance = std::min(1.0, std::sqrt(data.minimumNorm[index]) / 2);
+		double value = 255 * (1 - distance);
+		
+		ColorizerDetail::setColor(pixel, value, value * 0.6, value * 0.2);
+	}
+};
+
+// The set lit as a relief, whose normal at c is the direction of z / dz/dc,
+// by a light coming from the top right, which conjugation would move to the
+// bottom right
+struct LightingColorizer {
+	typedef PixelOutputs<true, true, false> Outputs;
+	static const bool conjugateSymmetric = false;
+	
+	static void color(unsigned char *pixel, const PixelData& data, unsigned index, int resolution)
+	{
+		const double light_r = 0.70710678118654752;
+		const double light_i = -0.70710678118654752;
+		const double height = 1.5;
+		
+		if (data.iterations[index] == resolution)
+		{
+			ColorizerDetail::setInterior(pixel);
+			return;
+		}
+		
+		// z / dz has the direction of z * conj(dz)
+		double z_r = data.z_r[index];
+		double z_i = data.z_i[index];
+		double dz_r = data.dz_r[index];
+		double dz_i = data.dz_i[index];
+		double u_r = z_r * dz_r + z_i * dz_i;
+		double u_i = z_i * dz_r - z_r * dz_i;
+		double length = std::sqrt(u_r * u_r + u_i * u_i);
+		double shade = 0;
+		
+		if (length > 0)
+			shade = std::max(0.0, ((u_r * light_r + u_i * light_i) / length + height) / (1 + height));
+		
+		ColorizerDetail::setColor(pixel, 255 * shade, 220 * shade, 180 * shade);
+	}
+};
+
+// Distance estimation: the closer to the set in pixels, the darker, which
+// shows filaments far thinner than a pixel
+struct DistanceColorizer {
+	typedef PixelOutputs<true, true, false> Outputs;
+	static const bool conjugateSymmetric = true;
+	
+	static void color(unsigned char *pixel, const PixelData& data, unsigned index, int resolution)
+	{
+		// Distance in pixels at which the color fades into the background
+		const double range = 4;
+		
+		if (data.iterations[index] == resolution)
+		{
+			ColorizerDetail::setInterior(pixel);
+			return;
+		}
+		
+		double distance = estimateDistance(data, index) / data.pixelSpacing;
+		double value = std::sqrt(std::min(1.0, distance / range));
+		
+		ColorizerDetail::setColor(pixel, 255 * value, 255 * value, 255 * value);
+	}
+};
+
+#endif
@@ -0,0 +1,109 @@
+
+/*
+ *  CpuFeatures.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "CpuFeatures.hpp"
+
+#if defined(_MSC_VER) && defined(FRACTAL_X86_KERNELS)
+#include <intrin.h>
+#elif defined(FRACTAL_X86_KERNELS)
+#include <cpuid.h>
+#endif
+
+namespace {
+#ifdef FRACTAL_X86_KERNELS
+	struct CpuidRegisters {
+		unsigned eax, ebx, ecx, edx;
+	};
+	
+	CpuidRegisters cpuid(unsigned leaf, unsigned subleaf)
+	{
+		CpuidRegisters r = {0, 0, 0, 0};
+#ifdef _MSC_VER
+		int regs[4];
+		__cpuidex(regs, leaf, subleaf);
+		r.eax = regs[0];
+		r.ebx = regs[1];
+		r.ecx = regs[2];
+		r.edx = regs[3];
+#else
+		if (leaf <= __get_cpuid_max(leaf & 0x80000000, 0))
+			__cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+		return r;
+	}
+	
+	// Mask of the register states the OS saves (XCR0)
+	unsigned long long enabledRegisterStates(void)
+	{
+		if ((cpuid(1, 0).ecx & (1 << 27)) == 0) // OSXSAVE
+			return 0;
+		
+#ifdef _MSC_VER
+		return _xgetbv(0);
+#else
+		unsigned eax, edx;
+		__asm__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((unsigned long long)edx << 32) | eax;
+#endif
+	}
+#endif
+}
+
+bool cpuSupportsSSE2(void)
+{
+#ifdef FRACTAL_X86_KERNELS
+	return (cpuid(1, 0).edx & (1 << 26)) != 0;
+#else
+	return false;
+#endif
+}
+
+bool cpuSupportsAVX2(void)
+{
+#ifdef FRACTAL_X86_KERNELS
+	const unsigned long long ymmState = 0x6;
+	
+	return (cpuid(1, 0).ecx & (1 << 28)) != 0 &&	// AVX
+		(cpuid(1, 0).ecx & (1 << 12)) != 0 &&		// FMA
+		(cpuid(7, 0).ebx & (1 << 5)) != 0 &&		// AVX2
+		(enabledRegisterStates() & ymmState) == ymmState;
+#else
+	return false;
+#endif
+}
+
+bool cpuSupportsAVX512(void)
+{
+#ifdef FRACTAL_X86_KERNELS
+	const unsigned long long zmmState = 0xe6;
+	
+	return (cpuid(7, 0).ebx & (1 << 16)) != 0 &&	// AVX-512F
+		(enabledRegisterStates() & zmmState) == zmmState;
+#else
+	return false;
+#endif
+}
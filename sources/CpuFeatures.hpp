@@ -0,0 +1,55 @@
+
+/*
+ *  CpuFeatures.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define FRACTAL_X86_KERNELS 1
+#endif
+
+// 128 bits integers are a GCC and Clang extension, on 64 bits targets only
+#ifdef __SIZEOF_INT128__
+#define FRACTAL_FIXED_POINT_KERNELS 1
+#endif
+
+// Lets a single function use instructions the rest of the binary is not
+// compiled for. MSVC accepts any intrinsic without it.
+#if defined(__GNUC__) || defined(__clang__)
+#define FRACTAL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define FRACTAL_TARGET(isa)
+#endif
+
+// Instruction sets usable on the host, as reported by cpuid. The wide vector
+// sets also require the OS to save the matching registers on context switch.
+// AVX2 is only reported along with FMA, which every AVX2 CPU has.
+bool cpuSupportsSSE2(void);
+bool cpuSupportsAVX2(void);
+bool cpuSupportsAVX512(void);
+
+#endif
@@ -0,0 +1,139 @@
+
+/*
+ *  DoubleDouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef DOUBLE_DOUBLE_HPP
+#define DOUBLE_DOUBLE_HPP
+
+#include <cmath>
+
+// Unevaluated sum of two doubles, giving about 106 bits of mantissa. The
+// operations follow Dekker and Bailey's error-free transformations, which
+// only hold if the compiler does not fuse multiplications and additions.
+// The SIMD kernels perform exactly the same operations in the same order,
+// so that every kernel gives the same iteration counts.
+class DoubleDouble {
+public:
+	DoubleDouble(void) : hi(0), lo(0) {}
+	DoubleDouble(double value) : hi(value), lo(0) {}
+	DoubleDouble(double high, double low) : hi(high), lo(low) {}
+	
+	double hi;
+	double lo;
+};
+
+// Exact sum when |a| >= |b|
+inline DoubleDouble quickTwoSum(double a, double b)
+{
+	double s = a + b;
+	return DoubleDouble(s, b - (s - a));
+}
+
+inline DoubleDouble twoSum(double a, double b)
+{
+	double s = a + b;
+	double bb = s - a;
+	return DoubleDouble(s, (a - (s - bb)) + (b - bb));
+}
+
+inline DoubleDouble twoProd(double a, double b)
+{
+	double p = a * b;
+#ifdef FP_FAST_FMA
+	return DoubleDouble(p, std::fma(a, b, -p));
+#else
+	const double splitter = 134217729.0; // 2^27 + 1
+	double t = splitter * a;
+	double a_hi = t - (t - a);
+	double a_lo = a - a_hi;
+	t = splitter * b;
+	double b_hi = t - (t - b);
+	double b_lo = b - b_hi;
+	return DoubleDouble(p, ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo);
+#endif
+}
+
+inline DoubleDouble operator-(const DoubleDouble& a)
+{
+	return DoubleDouble(-a.hi, -a.lo);
+}
+
+inline DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b)
+{
+	DoubleDouble s = twoSum(a.hi, b.hi);
+	return quickTwoSum(s.hi, s.lo + (a.lo + b.lo));
+}
+
+inline DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b)
+{
+	return a + -b;
+}
+
+inline DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b)
+{
+	DoubleDouble p = twoProd(a.hi, b.hi);
+	return quickTwoSum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+inline DoubleDouble operator/(const DoubleDouble& a, double b)
+{
+	double q1 = a.hi / b;
+	DoubleDouble r = a - twoProd(q1, b);
+	return quickTwoSum(q1, r.hi / b);
+}
+
+inline DoubleDouble& operator+=(DoubleDouble& a, const DoubleDouble& b)
+{
+	return a = a + b;
+}
+
+inline DoubleDouble& operator-=(DoubleDouble& a, const DoubleDouble& b)
+{
+	return a = a - b;
+}
+
+inline DoubleDouble sqr(const DoubleDouble& a)
+{
+	DoubleDouble p = twoProd(a.hi, a.hi);
+	return quickTwoSum(p.hi, p.lo + (a.hi + a.hi) * a.lo);
+}
+
+inline DoubleDouble floor(const DoubleDouble& a)
+{
+	double hi = std::floor(a.hi);
+	
+	if (hi != a.hi)
+		return DoubleDouble(hi);
+	
+	return quickTwoSum(hi, std::floor(a.lo));
+}
+
+inline DoubleDouble trunc(const DoubleDouble& a)
+{
+	return (a.hi < 0) ? -floor(-a) : floor(a);
+}
+
+#endif
@@ -0,0 +1,871 @@
+
+/*
+ *  EscapeTimeKernels.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+// The double-double arithmetic breaks if multiplications and additions get
+// fused, which GCC does by default when the target has FMA
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#include "EscapeTimeKernels.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+	typedef PixelOutputs<false, false, false> IterationOutputs;
+	
+	// Running values of the extra outputs along an orbit. The descriptor's
+	// flags are constants, so that the unused ones cost nothing.
+	template <class Outputs>
+	struct OrbitOutputs {
+		double dz_r;
+		double dz_i;
+		double minimumNorm;
+		
+		OrbitOutputs(void) : dz_r(0), dz_i(0), minimumNorm(DBL_MAX) {}
+		
+		// dz/dc becomes 2 z dz/dc + 1, from the z before the iteration
+		void iterate(double z_r, double z_i)
+		{
+			if (Outputs::derivative)
+			{
+				double tmp = dz_r;
+				dz_r = 2 * (z_r * dz_r - z_i * dz_i) + 1;
+				dz_i = 2 * (z_r * dz_i + z_i * tmp);
+			}
+		}
+		
+		void update(double norm)
+		{
+			if (Outputs::minimumNorm)
+				minimumNorm = std::min(minimumNorm, norm);
+		}
+		
+		void store(const PixelData& data, unsigned x, int i, int resolution, double z_r, double z_i) const
+		{
+			data.iterations[x] = i;
+			
+			if (!Outputs::extras || i == resolution)
+				return;
+			
+			if (Outputs::finalZ)
+			{
+				data.z_r[x] = z_r;
+				data.z_i[x] = z_i;
+			}
+			
+			if (Outputs::derivative)
+			{
+				data.dz_r[x] = dz_r;
+				data.dz_i[x] = dz_i;
+			}
+			
+			if (Outputs::minimumNorm)
+				data.minimumNorm[x] = minimumNorm;
+		}
+	};
+	
+	template <bool CheckPeriod, class Outputs, typename Real>
+	void escapeTime(const Real *c_r, Real c_i, unsigned count, int resolution, Real tolerance, const PixelData& data)
+	{
+		for (unsigned x = 0; x < count; x++)
+		{
+			if (isInMainCardioidOrBulb(c_r[x], c_i))
+			{
+				data.iterations[x] = resolution;
+				continue;
+			}
+			
+			Real z_r = 0;
+			Real z_i = 0;
+			Real p_r = 0;
+			Real p_i = 0;
+			Real norm;
+			OrbitOutputs<Outputs> orbit;
+			int checkpoint = 1;
+			int i = 0;
+			
+			do{
+				orbit.iterate(z_r, z_i);
+				Real tmp = z_r;
+				z_r = z_r * z_r - z_i * z_i + c_r[x];
+				z_i = 2 * tmp * z_i + c_i;
+				i++;
+				norm = z_r * z_r + z_i * z_i;
+				orbit.update(norm);
+				
+				if (CheckPeriod && norm < 4 && i < resolution)
+				{
+					if (std::fabs(z_r - p_r) + std::fabs(z_i - p_i) < tolerance)
+						i = resolution;
+					
+					if (i == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (norm < 4 && i < resolution);
+			
+			orbit.store(data, x, i, resolution, z_r, z_i);
+		}
+	}
+}
+
+bool isProvenInterior(const Interval& c_r, const Interval& c_i, int resolution)
+{
+	Interval z_r = c_r;
+	Interval z_i = c_i;
+	Interval p_r = z_r;
+	Interval p_i = z_i;
+	int checkpoint = 2;
+	
+	for (int i = 1; i < resolution; i++)
+	{
+		Interval tmp = sqr(z_r) - sqr(z_i) + c_r;
+		z_i = (z_r + z_r) * z_i + c_i;
+		z_r = tmp;
+		
+		if (magnitude(z_r) > 2 || magnitude(z_i) > 2)
+			return false;
+		
+		if (contains(p_r, z_r) && contains(p_i, z_i))
+			return true;
+		
+		if (i == checkpoint)
+		{
+			p_r = z_r;
+			p_i = z_i;
+			checkpoint *= 2;
+		}
+	}
+	
+	return false;
+}
+
+void escapeTimeScalar(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true, IterationOutputs>(c_r, c_i, count, resolution, tolerance, PixelData(iterations));
+	else
+		escapeTime<false, IterationOutputs>(c_r, c_i, count, resolution, tolerance, PixelData(iterations));
+}
+
+void escapeTimeScalarFloat(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true, IterationOutputs>(c_r, c_i, count, resolution, tolerance, PixelData(iterations));
+	else
+		escapeTime<false, IterationOutputs>(c_r, c_i, count, resolution, tolerance, PixelData(iterations));
+}
+
+namespace {
+	// Iterations run by batches whose escape is only checked at their end.
+	// Once out of the disc of radius 2, z can only get further from it, so
+	// an orbit that escaped during a batch is still out at its end. It is
+	// then iterated again one step at a time from the start of the batch to
+	// find the exact escape iteration, and likewise when it settles on a
+	// cycle during the batch.
+	const int batchLength = 8;
+	
+	template <bool CheckPeriod, typename Real>
+	void escapeTimeBatched(const Real *c_r, Real c_i, unsigned count, int resolution, Real tolerance, int *iterations)
+	{
+		for (unsigned x = 0; x < count; x++)
+		{
+			if (isInMainCardioidOrBulb(c_r[x], c_i))
+			{
+				iterations[x] = resolution;
+				continue;
+			}
+			
+			Real z_r = 0;
+			Real z_i = 0;
+			Real p_r = 0;
+			Real p_i = 0;
+			Real norm;
+			int checkpoint = 1;
+			int i = 0;
+			
+			// The checkpoints below the batch length are passed one step at a
+			// time, so that the next ones all fall at the end of a batch
+			int unbatched = CheckPeriod ? batchLength : 0;
+			
+			for (;;)
+			{
+				if (i >= unbatched && i + batchLength < resolution)
+				{
+					Real s_r = z_r;
+					Real s_i = z_i;
+					bool periodic = false;
+					
+					for (int k = 0; k < batchLength; k++)
+					{
+						Real tmp = z_r;
+						z_r = z_r * z_r - z_i * z_i + c_r[x];
+						z_i = 2 * tmp * z_i + c_i;
+						
+						if (CheckPeriod)
+							periodic |= std::fabs(z_r - p_r) + std::fabs(z_i - p_i) < tolerance;
+					}
+					
+					// Also false for the infinities and NaNs of escaped orbits
+					norm = z_r * z_r + z_i * z_i;
+					
+					if (norm < 4 && !periodic)
+					{
+						i += batchLength;
+						
+						if (CheckPeriod && i == checkpoint)
+						{
+							p_r = z_r;
+							p_i = z_i;
+							checkpoint *= 2;
+						}
+						
+						continue;
+					}
+					
+					z_r = s_r;
+					z_i = s_i;
+					unbatched = resolution;
+				}
+				
+				Real tmp = z_r;
+				z_r = z_r * z_r - z_i * z_i + c_r[x];
+				z_i = 2 * tmp * z_i + c_i;
+				i++;
+				norm = z_r * z_r + z_i * z_i;
+				
+				if (CheckPeriod && norm < 4 && i < resolution)
+				{
+					if (std::fabs(z_r - p_r) + std::fabs(z_i - p_i) < tolerance)
+						i = resolution;
+					
+					if (i == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+				
+				if (!(norm < 4 && i < resolution))
+					break;
+			}
+			
+			iterations[x] = i;
+		}
+	}
+}
+
+void escapeTimeBatched(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeBatched<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTimeBatched<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+void escapeTimeBatchedFloat(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeBatched<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTimeBatched<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+namespace {
+	// Pixels iterated side by side by the interleaved kernels. The iteration
+	// of a single pixel is a chain of dependent multiplications and additions,
+	// which leaves the floating point units waiting on their latency most of
+	// the time. Independent chains fill these gaps.
+	const unsigned interleave = 4;
+	
+	template <typename Real>
+	struct Lanes {
+		Real c_r[interleave];
+		Real z_r[interleave];
+		Real z_i[interleave];
+		Real p_r[interleave];
+		Real p_i[interleave];
+		int checkpoint[interleave];
+		int i[interleave];
+		unsigned x[interleave];
+	};
+	
+	// Gives the lane the next pixel to iterate, or leaves it idle with an
+	// 'x' of 'count' once there are none left. Idle lanes keep z at 0.
+	template <typename Real>
+	bool loadLane(Lanes<Real>& lanes, unsigned lane, const Real *c_r, Real c_i, unsigned count,
+				  int resolution, unsigned& next, int *iterations)
+	{
+		while (next < count && isInMainCardioidOrBulb(c_r[next], c_i))
+			iterations[next++] = resolution;
+		
+		lanes.x[lane] = next;
+		lanes.c_r[lane] = (next < count) ? c_r[next] : 0;
+		lanes.z_r[lane] = 0;
+		lanes.z_i[lane] = 0;
+		lanes.p_r[lane] = 0;
+		lanes.p_i[lane] = 0;
+		lanes.checkpoint[lane] = 1;
+		lanes.i[lane] = 0;
+		
+		if (next == count)
+			return false;
+		
+		next++;
+		return true;
+	}
+	
+	// Each lane makes the same operations as the scalar kernels, and is given
+	// the next pixel of the run as soon as its own one is done
+	template <bool CheckPeriod, typename Real>
+	void escapeTimeInterleaved(const Real *c_r, Real c_i, unsigned count, int resolution, Real tolerance, int *iterations)
+	{
+		Lanes<Real> lanes;
+		unsigned next = 0;
+		unsigned busy = 0;
+		
+		for (unsigned lane = 0; lane < interleave; lane++)
+		{
+			if (loadLane(lanes, lane, c_r, c_i, count, resolution, next, iterations))
+				busy++;
+		}
+		
+		while (busy > 0)
+		{
+			for (unsigned lane = 0; lane < interleave; lane++)
+			{
+				Real tmp = lanes.z_r[lane];
+				lanes.z_r[lane] = lanes.z_r[lane] * lanes.z_r[lane] - lanes.z_i[lane] * lanes.z_i[lane] + lanes.c_r[lane];
+				lanes.z_i[lane] = 2 * tmp * lanes.z_i[lane] + c_i;
+				lanes.i[lane]++;
+			}
+			
+			for (unsigned lane = 0; lane < interleave; lane++)
+			{
+				if (lanes.x[lane] == count)
+					continue;
+				
+				Real z_r = lanes.z_r[lane];
+				Real z_i = lanes.z_i[lane];
+				Real norm = z_r * z_r + z_i * z_i;
+				int& i = lanes.i[lane];
+				
+				if (CheckPeriod && norm < 4 && i < resolution)
+				{
+					if (std::fabs(z_r - lanes.p_r[lane]) + std::fabs(z_i - lanes.p_i[lane]) < tolerance)
+						i = resolution;
+					
+					if (i == lanes.checkpoint[lane])
+					{
+						lanes.p_r[lane] = z_r;
+						lanes.p_i[lane] = z_i;
+						lanes.checkpoint[lane] *= 2;
+					}
+				}
+				
+				if (!(norm < 4 && i < resolution))
+				{
+					iterations[lanes.x[lane]] = i;
+					
+					if (!loadLane(lanes, lane, c_r, c_i, count, resolution, next, iterations))
+						busy--;
+				}
+			}
+		}
+	}
+}
+
+void escapeTimeInterleaved(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeInterleaved<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTimeInterleaved<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+void escapeTimeInterleavedFloat(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeInterleaved<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTimeInterleaved<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+namespace {
+	// The saved z is subtracted part by part, which is exact enough as the
+	// high parts are equal or next to each other by the time the orbit repeats
+	template <bool CheckPeriod, class Outputs>
+	void escapeTimeDD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+					  unsigned count, int resolution, double tolerance, const PixelData& data)
+	{
+		for (unsigned x = 0; x < count; x++)
+		{
+			const DoubleDouble c_r(c_r_hi[x], c_r_lo[x]);
+			DoubleDouble z_r;
+			DoubleDouble z_i;
+			DoubleDouble p_r;
+			DoubleDouble p_i;
+			double norm;
+			OrbitOutputs<Outputs> orbit;
+			int checkpoint = 1;
+			int i = 0;
+			
+			do{
+				orbit.iterate(z_r.hi, z_i.hi);
+				DoubleDouble z_ri = z_r * z_i;
+				z_r = (sqr(z_r) - sqr(z_i)) + c_r;
+				z_i = DoubleDouble(2 * z_ri.hi, 2 * z_ri.lo) + c_i;
+				i++;
+				norm = z_r.hi * z_r.hi + z_i.hi * z_i.hi;
+				orbit.update(norm);
+				
+				if (CheckPeriod && norm < 4 && i < resolution)
+				{
+					if (std::fabs((z_r.hi - p_r.hi) + (z_r.lo - p_r.lo))
+						+ std::fabs((z_i.hi - p_i.hi) + (z_i.lo - p_i.lo)) < tolerance)
+						i = resolution;
+					
+					if (i == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (norm < 4 && i < resolution);
+			
+			orbit.store(data, x, i, resolution, z_r.hi, z_i.hi);
+		}
+	}
+}
+
+void escapeTimeScalarDD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeDD<true, IterationOutputs>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, PixelData(iterations));
+	else
+		escapeTimeDD<false, IterationOutputs>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, PixelData(iterations));
+}
+
+#ifdef FRACTAL_FIXED_POINT_KERNELS
+namespace {
+	typedef __int128 Fixed;
+	typedef unsigned __int128 UnsignedFixed;
+	
+	const unsigned fractionBits = 123;
+	
+	// The fixed-point numbers only reach 16 in magnitude. Coordinates past
+	// this bound escape at the first iteration, like any coordinate past 2.
+	const double fixedBound = 8;
+	
+	// Truncated towards zero, for magnitudes below fixedBound
+	Fixed toFixed(const DoubleDouble& value)
+	{
+		return (Fixed)std::ldexp(value.hi, fractionBits) + (Fixed)std::ldexp(value.lo, fractionBits);
+	}
+	
+	// (a * b) >> fractionBits, rounded down. The 256 bits product is put
+	// together from four 64 x 64 bits products of the signed high halves and
+	// unsigned low halves, of which only the bits above 2^fractionBits are
+	// kept.
+	Fixed multiply(Fixed a, Fixed b)
+	{
+		int64_t a_hi = (int64_t)(a >> 64);
+		uint64_t a_lo = (uint64_t)a;
+		int64_t b_hi = (int64_t)(b >> 64);
+		uint64_t b_lo = (uint64_t)b;
+		
+		UnsignedFixed lo_lo = (UnsignedFixed)a_lo * b_lo;
+		Fixed hi_lo = (Fixed)a_hi * b_lo;
+		Fixed lo_hi = (Fixed)b_hi * a_lo;
+		Fixed hi_hi = (Fixed)a_hi * b_hi;
+		UnsignedFixed middle = (lo_lo >> 64) + (uint64_t)hi_lo + (uint64_t)lo_hi;
+		Fixed high = hi_hi + (hi_lo >> 64) + (lo_hi >> 64) + (Fixed)(middle >> 64);
+		
+		return high * ((Fixed)1 << (128 - fractionBits)) + (Fixed)((uint64_t)middle >> (fractionBits - 64));
+	}
+	
+
+	Fixed absolute(Fixed value)
+	{
+		return value < 0 ? -value : value;
+	}
+	
+	template <bool CheckPeriod>
+	void escapeTimeFixed(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						 unsigned count, int resolution, double tolerance, int *iterations)
+	{
+		// Values stay below 16 in magnitude until the escape is detected. The
+		// escape test only needs the 64 high bits of z.
+		if (std::fabs(c_i.hi) >= fixedBound)
+		{
+			for (unsigned x = 0; x < count; x++)
+				iterations[x] = 1;
+			
+			return;
+		}
+		
+		const Fixed c_i_fixed = toFixed(c_i);
+		const Fixed four = (Fixed)4 << (2 * (fractionBits - 64));
+		const Fixed tolerance_fixed = toFixed(tolerance);
+		
+		for (unsigned x = 0; x < count; x++)
+		{
+			if (std::fabs(c_r_hi[x]) >= fixedBound)
+			{
+				iterations[x] = 1;
+				continue;
+			}
+			
+			const Fixed c_r = toFixed(DoubleDouble(c_r_hi[x], c_r_lo[x]));
+			Fixed z_r = 0;
+			Fixed z_i = 0;
+			Fixed p_r = 0;
+			Fixed p_i = 0;
+			Fixed norm;
+			int checkpoint = 1;
+			int i = 0;
+			
+			do{
+				Fixed z_ri = multiply(z_r, z_i);
+				z_r = multiply(z_r + z_i, z_r - z_i) + c_r;
+				z_i = (z_ri + z_ri) + c_i_fixed;
+				i++;
+				
+				int64_t z_r_hi = (int64_t)(z_r >> 64);
+				int64_t z_i_hi = (int64_t)(z_i >> 64);
+				norm = (Fixed)z_r_hi * z_r_hi + (Fixed)z_i_hi * z_i_hi;
+				
+				if (CheckPeriod && norm < four && i < resolution)
+				{
+					if (absolute(z_r - p_r) + absolute(z_i - p_i) < tolerance_fixed)
+						i = resolution;
+					
+					if (i == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (norm < four && i < resolution);
+			
+			iterations[x] = i;
+		}
+	}
+}
+
+void escapeTimeFixed128(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeFixed<true>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTimeFixed<false>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, iterations);
+}
+#endif
+
+namespace {
+	template <bool CheckPeriod, class Outputs>
+	void escapeTimeQD(const QuadDouble *c_r, const QuadDouble& c_i,
+					  unsigned count, int resolution, double tolerance, const PixelData& data)
+	{
+		for (unsigned x = 0; x < count; x++)
+		{
+			QuadDouble z_r;
+			QuadDouble z_i;
+			QuadDouble p_r;
+			QuadDouble p_i;
+			double norm;
+			OrbitOutputs<Outputs> orbit;
+			int checkpoint = 1;
+			int i = 0;
+			
+			// z_r^2 - z_i^2 is computed as (z_r + z_i)(z_r - z_i), since
+			// quad-double multiplications cost much more than additions
+			do{
+				orbit.iterate(z_r.parts[0], z_i.parts[0]);
+				QuadDouble z_ri = z_r * z_i;
+				z_r = (z_r + z_i) * (z_r - z_i) + c_r[x];
+				z_i = (z_ri + z_ri) + c_i;
+				i++;
+				norm = z_r.parts[0] * z_r.parts[0] + z_i.parts[0] * z_i.parts[0];
+				orbit.update(norm);
+				
+				// The last part is always below the pixel spacing
+				if (CheckPeriod && norm < 4 && i < resolution)
+				{
+					double d_r = (z_r.parts[0] - p_r.parts[0]) + (z_r.parts[1] - p_r.parts[1]) + (z_r.parts[2] - p_r.parts[2]);
+					double d_i = (z_i.parts[0] - p_i.parts[0]) + (z_i.parts[1] - p_i.parts[1]) + (z_i.parts[2] - p_i.parts[2]);
+					
+					if (std::fabs(d_r) + std::fabs(d_i) < tolerance)
+						i = resolution;
+					
+					if (i == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (norm < 4 && i < resolution);
+			
+			orbit.store(data, x, i, resolution, z_r.parts[0], z_i.parts[0]);
+		}
+	}
+}
+
+void escapeTimeScalarQD(const QuadDouble *c_r, const QuadDouble& c_i,
+						unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTimeQD<true, IterationOutputs>(c_r, c_i, count, resolution, tolerance, PixelData(iterations));
+	else
+		escapeTimeQD<false, IterationOutputs>(c_r, c_i, count, resolution, tolerance, PixelData(iterations));
+}
+
+template <class Outputs>
+void EscapeTimeOutputKernels<Outputs>::kernel(const double *c_r, double c_i, unsigned count,
+											  int resolution, double tolerance, const PixelData& data)
+{
+	if (tolerance > 0)
+		escapeTime<true, Outputs>(c_r, c_i, count, resolution, tolerance, data);
+	else
+		escapeTime<false, Outputs>(c_r, c_i, count, resolution, tolerance, data);
+}
+
+template <class Outputs>
+void EscapeTimeOutputKernels<Outputs>::floatKernel(const float *c_r, float c_i, unsigned count,
+												   int resolution, float tolerance, const PixelData& data)
+{
+	if (tolerance > 0)
+		escapeTime<true, Outputs>(c_r, c_i, count, resolution, tolerance, data);
+	else
+		escapeTime<false, Outputs>(c_r, c_i, count, resolution, tolerance, data);
+}
+
+template <class Outputs>
+void EscapeTimeOutputKernels<Outputs>::doubleDoubleKernel(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+														  unsigned count, int resolution, double tolerance,
+														  const PixelData& data)
+{
+	if (tolerance > 0)
+		escapeTimeDD<true, Outputs>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, data);
+	else
+		escapeTimeDD<false, Outputs>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, data);
+}
+
+template <class Outputs>
+void EscapeTimeOutputKernels<Outputs>::quadDoubleKernel(const QuadDouble *c_r, const QuadDouble& c_i,
+														unsigned count, int resolution, double tolerance,
+														const PixelData& data)
+{
+	if (tolerance > 0)
+		escapeTimeQD<true, Outputs>(c_r, c_i, count, resolution, tolerance, data);
+	else
+		escapeTimeQD<false, Outputs>(c_r, c_i, count, resolution, tolerance, data);
+}
+
+// The output sets of the colorizers
+template struct EscapeTimeOutputKernels<PixelOutputs<false, false, false> >;
+template struct EscapeTimeOutputKernels<PixelOutputs<true, false, false> >;
+template struct EscapeTimeOutputKernels<PixelOutputs<false, false, true> >;
+template struct EscapeTimeOutputKernels<PixelOutputs<true, true, false> >;
+
+// The orbit trap outputs with the final z and dz/dc, for the distance estimates
+template struct EscapeTimeOutputKernels<PixelOutputs<true, true, true> >;
+
+namespace {
+	// Perturbation iterations of a single pixel, from iteration i of the pixel
+	// and m of the reference orbit, until it escapes or reaches 'resolution'.
+	//
+	// z is only known to double precision, far from the pixel spacing, so
+	// the periodicity is checked on the offset instead: z is back to a
+	// previous value if the reference is, to its own rounding errors, and the
+	// offset too, within 'tolerance'. The bilinear approximation skips
+	// iterations, so z is saved at the first iteration past each checkpoint.
+	template <bool CheckPeriod>
+	int perturb(const PerturbationReference& reference, int i, int m, double d_r, double d_i,
+				double dc_r, double dc_i, int resolution, double tolerance)
+	{
+		const BilinearApproximation& bilinear = reference.getBilinear();
+		const double *Z_r = reference.getOrbit().getRealParts();
+		const double *Z_i = reference.getOrbit().getImaginaryParts();
+		int last = reference.getOrbit().getLength() - 1;
+		double z_norm;
+		const double referenceTolerance = 64 * DBL_EPSILON;
+		double p_r = d_r;
+		double p_i = d_i;
+		int p_m = m;
+		int checkpoint = 1;
+		
+		while (checkpoint <= i)
+			checkpoint *= 2;
+		
+		// d' = (2Z + d)d + dc, so that z' = Z' + d' without ever subtracting
+		// two close values
+		do{
+			int previous = m;
+			
+			if (bilinear.jump(m, d_r, d_i, dc_r, dc_i, std::min(last, m + resolution - i)))
+			{
+				i += m - previous;
+			}
+			else
+			{
+				double t_r = 2 * Z_r[m] + d_r;
+				double t_i = 2 * Z_i[m] + d_i;
+				double tmp = d_r;
+				d_r = t_r * d_r - t_i * d_i + dc_r;
+				d_i = t_r * d_i + t_i * tmp + dc_i;
+				m++;
+				i++;
+			}
+			
+			double z_r = Z_r[m] + d_r;
+			double z_i = Z_i[m] + d_i;
+			z_norm = z_r * z_r + z_i * z_i;
+			
+			if (CheckPeriod && z_norm < 4 && i < resolution)
+			{
+				if (std::fabs(d_r - p_r) + std::fabs(d_i - p_i) < tolerance
+					&& std::fabs(Z_r[m] - Z_r[p_m]) + std::fabs(Z_i[m] - Z_i[p_m]) < referenceTolerance)
+					i = resolution;
+				
+				if (i >= checkpoint)
+				{
+					p_r = d_r;
+					p_i = d_i;
+					p_m = m;
+					checkpoint *= 2;
+				}
+			}
+			
+			// As Z_0 = 0, z is its own offset from the start of the reference
+			if (z_norm < d_r * d_r + d_i * d_i || m == last)
+			{
+				d_r = z_r;
+				d_i = z_i;
+				m = 0;
+			}
+		} while (z_norm < 4 && i < resolution);
+		
+		return i;
+	}
+	
+	int perturb(const PerturbationReference& reference, int i, int m, double d_r, double d_i,
+				double dc_r, double dc_i, int resolution, double tolerance)
+	{
+		if (tolerance > 0)
+			return perturb<true>(reference, i, m, d_r, d_i, dc_r, dc_i, resolution, tolerance);
+		else
+			return perturb<false>(reference, i, m, d_r, d_i, dc_r, dc_i, resolution, tolerance);
+	}
+}
+
+void escapeTimePerturbation(const PerturbationReference& reference, const double *dc_r, double dc_i,
+							unsigned count, int resolution, double tolerance, int *iterations)
+{
+	const SeriesApproximation& series = reference.getSeries();
+	
+	for (unsigned x = 0; x < count; x++)
+	{
+		double d_r;
+		double d_i;
+		int i = series.getSkippedIterations();
+		
+		series.evaluate(dc_r[x], dc_i, d_r, d_i);
+		iterations[x] = perturb(reference, i, i, d_r, d_i, dc_r[x], dc_i, resolution, tolerance);
+	}
+}
+
+void escapeTimePerturbationFE(const PerturbationReference& reference, const FloatExp *dc_r, const FloatExp& dc_i,
+							  unsigned count, int resolution, double tolerance, int *iterations)
+{
+	// Past this, offsets fit in doubles and dc is negligible against them
+	const FloatExp doubleThreshold(1.0, -800);
+	const BilinearApproximation& bilinear = reference.getBilinear();
+	const double *Z_r = reference.getOrbit().getRealParts();
+	const double *Z_i = reference.getOrbit().getImaginaryParts();
+	int last = reference.getOrbit().getLength() - 1;
+	
+	for (unsigned x = 0; x < count; x++)
+	{
+		FloatExp d_r;
+		FloatExp d_i;
+		double z_norm = 0;
+		int i = 0;
+		int m = 0;
+		
+		// z is very close to Z as long as d is that small, so there is no need
+		// to rebase before the reference escapes
+		while (z_norm < 4 && i < resolution && fabs(d_r) + fabs(d_i) < doubleThreshold)
+		{
+			int previous = m;
+			
+			if (bilinear.jump(m, d_r, d_i, dc_r[x], dc_i, std::min(last, m + resolution - i)))
+			{
+				i += m - previous;
+			}
+			else
+			{
+				FloatExp t_r = d_r + 2 * Z_r[m];
+				FloatExp t_i = d_i + 2 * Z_i[m];
+				FloatExp tmp = d_r;
+				d_r = multiplyAdd(t_r, d_r, -t_i, d_i, dc_r[x]);
+				d_i = multiplyAdd(t_r, d_i, t_i, tmp, dc_i);
+				m++;
+				i++;
+			}
+			
+			double z_r = Z_r[m] + d_r.toDouble();
+			double z_i = Z_i[m] + d_i.toDouble();
+			z_norm = z_r * z_r + z_i * z_i;
+			
+			if (m == last)
+			{
+				d_r = z_r;
+				d_i = z_i;
+				m = 0;
+			}
+		}
+		
+		if (z_norm < 4 && i < resolution)
+			i = perturb(reference, i, m, d_r.toDouble(), d_i.toDouble(), dc_r[x].toDouble(), dc_i.toDouble(),
+							resolution, tolerance);
+		
+		iterations[x] = i;
+	}
+}
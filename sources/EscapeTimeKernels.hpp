@@ -0,0 +1,204 @@
+
+/*
+ *  EscapeTimeKernels.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef ESCAPE_TIME_KERNELS_HPP
+#define ESCAPE_TIME_KERNELS_HPP
+
+#include <cstddef>
+#include <cmath>
+#include "CpuFeatures.hpp"
+#include "DoubleDouble.hpp"
+#include "QuadDouble.hpp"
+#include "FloatExp.hpp"
+#include "Interval.hpp"
+#include "PerturbationReference.hpp"
+
+// An escape-time kernel iterates z = z^2 + c for a run of 'count' pixels
+// sharing the same imaginary part c_i, and stores in 'iterations' the number
+// of iterations each pixel needed to escape (at most 'resolution').
+// All kernels of a given precision must produce exactly the same counts.
+//
+// Unless 'tolerance' is 0, the kernels also look for orbits that have settled
+// on an attracting cycle, Brent style: z is saved at iterations 1, 2, 4, 8...
+// and a pixel is given 'resolution' as soon as z comes back within
+// 'tolerance' of the saved value, |dz_r| + |dz_i| being the distance.
+typedef void (*EscapeTimeKernel)(const double *c_r, double c_i, unsigned count,
+								 int resolution, double tolerance, int *iterations);
+
+// Single precision kernels fit twice as many pixels in a vector, but can
+// only be used while the pixel spacing is far above the float resolution.
+typedef void (*EscapeTimeKernelFloat)(const float *c_r, float c_i, unsigned count,
+									  int resolution, float tolerance, int *iterations);
+
+// Double-double kernels take the high and low parts of the real coordinates
+// as separate arrays so that SIMD versions can load them directly.
+typedef void (*EscapeTimeKernelDD)(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+								   unsigned count, int resolution, double tolerance, int *iterations);
+
+// Per-pixel values that some colorings need besides the iteration count.
+// They are only computed when an output descriptor asks for them, and only
+// stored for the pixels that escape. The arrays not asked for may be NULL.
+// The pixel spacing is for the colorings measured in pixels.
+struct PixelData {
+	explicit PixelData(int *iterations = NULL) :
+	iterations(iterations), z_r(NULL), z_i(NULL), dz_r(NULL), dz_i(NULL), minimumNorm(NULL), pixelSpacing(0) {}
+	
+	int *iterations;
+	double *z_r;
+	double *z_i;
+	double *dz_r;
+	double *dz_i;
+	double *minimumNorm;
+	double pixelSpacing;
+};
+
+// Exterior distance estimate of an escaped pixel from its final z and
+// dz/dc, |z| ln|z| / |dz/dc|. For large enough z, the distance from c to the
+// set lies between half and twice the estimate. With the escape radius of
+// 2, it is only a rough guide.
+inline double estimateDistance(const PixelData& data, unsigned index)
+{
+	double norm = data.z_r[index] * data.z_r[index] + data.z_i[index] * data.z_i[index];
+	double derivativeNorm = data.dz_r[index] * data.dz_r[index] + data.dz_i[index] * data.dz_i[index];
+	
+	return std::sqrt(norm / derivativeNorm) * std::log(norm) / 2;
+}
+
+// Output descriptor: the final z, the derivative dz/dc and the smallest
+// |z|^2 along the orbit. The kernels test these as constants, so that each
+// set of outputs gets its own kernel computing nothing else.
+template <bool FinalZ, bool Derivative, bool MinimumNorm>
+struct PixelOutputs {
+	static const bool finalZ = FinalZ;
+	static const bool derivative = Derivative;
+	static const bool minimumNorm = MinimumNorm;
+	static const bool extras = FinalZ || Derivative || MinimumNorm;
+};
+
+// Whether c lies in the main cardioid or in the period-2 bulb, where orbits
+// never escape: the float and double kernels give these pixels 'resolution'
+// without iterating them. The vector kernels make the same operations lane
+// by lane so that they reject exactly the same pixels. The double-double and
+// deeper kernels do not bother, as their views are far too small to contain
+// a significant part of either.
+template <typename Real>
+inline bool isInMainCardioidOrBulb(Real c_r, Real c_i)
+{
+	Real c_i2 = c_i * c_i;
+	Real x = c_r - Real(0.25);
+	Real q = x * x + c_i2;
+	Real b = c_r + Real(1);
+	
+	return q * (q + x) <= Real(0.25) * c_i2 || b * b + c_i2 <= Real(0.0625);
+}
+
+// Proof that a whole rectangle of c lies inside the set: z is iterated as a
+// box of intervals holding the orbits of all of them at once. Once the box
+// falls within a box it went through before, saved Brent style, every later
+// box falls within an earlier one, so that none of these orbits can escape.
+// Fails as soon as the box reaches past 2 in any direction, which an orbit of
+// the inside never does, or after 'resolution' iterations.
+bool isProvenInterior(const Interval& c_r, const Interval& c_i, int resolution);
+
+void escapeTimeScalar(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeScalarFloat(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations);
+void escapeTimeScalarDD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						unsigned count, int resolution, double tolerance, int *iterations);
+
+// Same counts as the scalar kernels, but the escape is only tested every few
+// iterations, which saves the compare and branch of the other iterations
+void escapeTimeBatched(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeBatchedFloat(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations);
+
+// Same counts as the scalar kernels, but a few pixels are iterated side by
+// side so that their dependency chains overlap, for hosts without SIMD kernels
+void escapeTimeInterleaved(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeInterleavedFloat(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations);
+
+// Kernels computing the outputs of the descriptor besides the iteration
+// counts, which are the same as the counts of the scalar kernels. They are
+// instantiated for the output sets of the colorizers only. The perturbation
+// kernels have no such versions, as they skip iterations with the series
+// and bilinear approximations.
+template <class Outputs>
+struct EscapeTimeOutputKernels {
+	static void kernel(const double *c_r, double c_i, unsigned count,
+					   int resolution, double tolerance, const PixelData& data);
+	static void floatKernel(const float *c_r, float c_i, unsigned count,
+							int resolution, float tolerance, const PixelData& data);
+	static void doubleDoubleKernel(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+								   unsigned count, int resolution, double tolerance, const PixelData& data);
+	static void quadDoubleKernel(const QuadDouble *c_r, const QuadDouble& c_i,
+								 unsigned count, int resolution, double tolerance, const PixelData& data);
+};
+
+#ifdef FRACTAL_FIXED_POINT_KERNELS
+// Replacement for the double-double kernels on 128 bits fixed-point integers,
+// with 123 fractional bits. It only involves integer operations, so that its
+// counts are the same on every host and with every compiler, but they are
+// not the same as the counts of the double-double kernels.
+void escapeTimeFixed128(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						unsigned count, int resolution, double tolerance, int *iterations);
+#endif
+
+// Quad-double renormalization is too branchy to be worth vectorizing, so
+// there is a single quad-double kernel, used whatever the instruction set.
+void escapeTimeScalarQD(const QuadDouble *c_r, const QuadDouble& c_i,
+						unsigned count, int resolution, double tolerance, int *iterations);
+
+// Perturbation kernel: the orbit z of each pixel is iterated as its offset
+// from the reference orbit Z, starting from the iteration the series
+// approximation skips to and jumping ahead with the bilinear approximation
+// whenever possible. The coordinates given are offsets from the reference
+// point. Whenever z gets closer to 0 than to Z, or Z escapes, the offset is
+// rebased onto the start of the reference orbit, so that the reference is
+// valid for every pixel. z itself is only known to double precision, which
+// the periodicity tolerance must stay above.
+void escapeTimePerturbation(const PerturbationReference& reference, const double *dc_r, double dc_i,
+							unsigned count, int resolution, double tolerance, int *iterations);
+
+// Same with floatexp offsets, for pixel spacings too small for doubles. The
+// offsets are switched to doubles as soon as they are large enough, and the
+// series approximation is not used: the bilinear approximation alone skips
+// the first iterations.
+void escapeTimePerturbationFE(const PerturbationReference& reference, const FloatExp *dc_r, const FloatExp& dc_i,
+							  unsigned count, int resolution, double tolerance, int *iterations);
+
+#ifdef FRACTAL_X86_KERNELS
+void escapeTimeSSE2(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeSSE2Float(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations);
+void escapeTimeAVX2(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeAVX2Float(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations);
+void escapeTimeAVX2DD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+					  unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeAVX512(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations);
+void escapeTimeAVX512Float(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations);
+void escapeTimeAVX512DD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						unsigned count, int resolution, double tolerance, int *iterations);
+#endif
+
+#endif
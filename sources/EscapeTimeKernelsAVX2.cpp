@@ -0,0 +1,347 @@
+
+/*
+ *  EscapeTimeKernelsAVX2.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+// The double-double kernel needs FMA, and GCC would then also fuse the
+// separate multiplications and additions, which changes the iteration counts
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#include "EscapeTimeKernels.hpp"
+
+#ifdef FRACTAL_X86_KERNELS
+
+#include <immintrin.h>
+
+namespace {
+	// Four double-doubles, see DoubleDouble.hpp for the scalar operations
+	struct DoubleDouble4 {
+		__m256d hi;
+		__m256d lo;
+	};
+	
+	FRACTAL_TARGET("avx2,fma")
+	inline DoubleDouble4 quickTwoSum(__m256d a, __m256d b)
+	{
+		DoubleDouble4 r;
+		r.hi = _mm256_add_pd(a, b);
+		r.lo = _mm256_sub_pd(b, _mm256_sub_pd(r.hi, a));
+		return r;
+	}
+	
+	FRACTAL_TARGET("avx2,fma")
+	inline DoubleDouble4 add(const DoubleDouble4& a, const DoubleDouble4& b)
+	{
+		__m256d s = _mm256_add_pd(a.hi, b.hi);
+		__m256d bb = _mm256_sub_pd(s, a.hi);
+		__m256d e = _mm256_add_pd(_mm256_sub_pd(a.hi, _mm256_sub_pd(s, bb)), _mm256_sub_pd(b.hi, bb));
+		return quickTwoSum(s, _mm256_add_pd(e, _mm256_add_pd(a.lo, b.lo)));
+	}
+	
+	FRACTAL_TARGET("avx2,fma")
+	inline DoubleDouble4 negate(const DoubleDouble4& a)
+	{
+		const __m256d sign = _mm256_set1_pd(-0.0);
+		DoubleDouble4 r;
+		r.hi = _mm256_xor_pd(a.hi, sign);
+		r.lo = _mm256_xor_pd(a.lo, sign);
+		return r;
+	}
+	
+	FRACTAL_TARGET("avx2,fma")
+	inline DoubleDouble4 mul(const DoubleDouble4& a, const DoubleDouble4& b)
+	{
+		__m256d p = _mm256_mul_pd(a.hi, b.hi);
+		__m256d e = _mm256_fmsub_pd(a.hi, b.hi, p);
+		__m256d t = _mm256_add_pd(_mm256_mul_pd(a.hi, b.lo), _mm256_mul_pd(a.lo, b.hi));
+		return quickTwoSum(p, _mm256_add_pd(e, t));
+	}
+	
+	FRACTAL_TARGET("avx2,fma")
+	inline DoubleDouble4 sqr(const DoubleDouble4& a)
+	{
+		__m256d p = _mm256_mul_pd(a.hi, a.hi);
+		__m256d e = _mm256_fmsub_pd(a.hi, a.hi, p);
+		__m256d t = _mm256_mul_pd(_mm256_add_pd(a.hi, a.hi), a.lo);
+		return quickTwoSum(p, _mm256_add_pd(e, t));
+	}
+	
+	// Lane by lane isInMainCardioidOrBulb(), given c_i^2
+	FRACTAL_TARGET("avx2")
+	inline __m256d mainCardioidOrBulbMask(__m256d cr, __m256d ci2)
+	{
+		const __m256d quarter = _mm256_set1_pd(0.25);
+		__m256d x = _mm256_sub_pd(cr, quarter);
+		__m256d q = _mm256_add_pd(_mm256_mul_pd(x, x), ci2);
+		__m256d b = _mm256_add_pd(cr, _mm256_set1_pd(1.0));
+		__m256d cardioid = _mm256_cmp_pd(_mm256_mul_pd(q, _mm256_add_pd(q, x)), _mm256_mul_pd(quarter, ci2), _CMP_LE_OQ);
+		__m256d bulb = _mm256_cmp_pd(_mm256_add_pd(_mm256_mul_pd(b, b), ci2), _mm256_set1_pd(0.0625), _CMP_LE_OQ);
+		return _mm256_or_pd(cardioid, bulb);
+	}
+	
+	FRACTAL_TARGET("avx2")
+	inline __m256 mainCardioidOrBulbMask(__m256 cr, __m256 ci2)
+	{
+		const __m256 quarter = _mm256_set1_ps(0.25f);
+		__m256 x = _mm256_sub_ps(cr, quarter);
+		__m256 q = _mm256_add_ps(_mm256_mul_ps(x, x), ci2);
+		__m256 b = _mm256_add_ps(cr, _mm256_set1_ps(1.0f));
+		__m256 cardioid = _mm256_cmp_ps(_mm256_mul_ps(q, _mm256_add_ps(q, x)), _mm256_mul_ps(quarter, ci2), _CMP_LE_OQ);
+		__m256 bulb = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(b, b), ci2), _mm256_set1_ps(0.0625f), _CMP_LE_OQ);
+		return _mm256_or_ps(cardioid, bulb);
+	}
+	
+	// See the SSE2 kernels for the periodicity checking in lockstep
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("avx2")
+	inline void escapeTime(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+	{
+		const __m256d one = _mm256_set1_pd(1.0);
+		const __m256d four = _mm256_set1_pd(4.0);
+		const __m256d limit = _mm256_set1_pd(resolution);
+		const __m256d ci = _mm256_set1_pd(c_i);
+		const __m256d ci2 = _mm256_set1_pd(c_i * c_i);
+		const __m256d sign = _mm256_set1_pd(-0.0);
+		const __m256d tol = _mm256_set1_pd(tolerance);
+		unsigned x = 0;
+		
+		for (; x + 4 <= count; x += 4)
+		{
+			const __m256d cr = _mm256_loadu_pd(c_r + x);
+			__m256d z_r = _mm256_setzero_pd();
+			__m256d z_i = _mm256_setzero_pd();
+			const __m256d inside = mainCardioidOrBulbMask(cr, ci2);
+			__m256d i = _mm256_and_pd(inside, limit);
+			__m256d active = _mm256_andnot_pd(inside, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)));
+			__m256d p_r = _mm256_setzero_pd();
+			__m256d p_i = _mm256_setzero_pd();
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				__m256d z_r2 = _mm256_mul_pd(z_r, z_r);
+				__m256d z_i2 = _mm256_mul_pd(z_i, z_i);
+				__m256d tmp = _mm256_add_pd(z_r, z_r);
+				
+				z_r = _mm256_add_pd(_mm256_sub_pd(z_r2, z_i2), cr);
+				z_i = _mm256_add_pd(_mm256_mul_pd(tmp, z_i), ci);
+				i = _mm256_add_pd(i, _mm256_and_pd(active, one));
+				
+				__m256d norm = _mm256_add_pd(_mm256_mul_pd(z_r, z_r), _mm256_mul_pd(z_i, z_i));
+				active = _mm256_and_pd(active, _mm256_cmp_pd(norm, four, _CMP_LT_OQ));
+				active = _mm256_and_pd(active, _mm256_cmp_pd(i, limit, _CMP_LT_OQ));
+				
+				if (CheckPeriod)
+				{
+					__m256d distance = _mm256_add_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(z_r, p_r)),
+													 _mm256_andnot_pd(sign, _mm256_sub_pd(z_i, p_i)));
+					__m256d periodic = _mm256_and_pd(active, _mm256_cmp_pd(distance, tol, _CMP_LT_OQ));
+					i = _mm256_blendv_pd(i, limit, periodic);
+					active = _mm256_andnot_pd(periodic, active);
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (_mm256_movemask_pd(active));
+			
+			_mm_storeu_si128((__m128i *)(iterations + x), _mm256_cvtpd_epi32(i));
+		}
+		
+		if (x < count)
+			escapeTimeScalar(c_r + x, c_i, count - x, resolution, tolerance, iterations + x);
+	}
+	
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("avx2")
+	inline void escapeTime(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+	{
+		const __m256 four = _mm256_set1_ps(4.0f);
+		const __m256i limit = _mm256_set1_epi32(resolution);
+		const __m256 ci = _mm256_set1_ps(c_i);
+		const __m256 ci2 = _mm256_set1_ps(c_i * c_i);
+		const __m256 sign = _mm256_set1_ps(-0.0f);
+		const __m256 tol = _mm256_set1_ps(tolerance);
+		unsigned x = 0;
+		
+		for (; x + 8 <= count; x += 8)
+		{
+			const __m256 cr = _mm256_loadu_ps(c_r + x);
+			__m256 z_r = _mm256_setzero_ps();
+			__m256 z_i = _mm256_setzero_ps();
+			const __m256 inside = mainCardioidOrBulbMask(cr, ci2);
+			__m256i i = _mm256_and_si256(_mm256_castps_si256(inside), limit);
+			__m256 active = _mm256_andnot_ps(inside, _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+			__m256 p_r = _mm256_setzero_ps();
+			__m256 p_i = _mm256_setzero_ps();
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				__m256 z_r2 = _mm256_mul_ps(z_r, z_r);
+				__m256 z_i2 = _mm256_mul_ps(z_i, z_i);
+				__m256 tmp = _mm256_add_ps(z_r, z_r);
+				
+				z_r = _mm256_add_ps(_mm256_sub_ps(z_r2, z_i2), cr);
+				z_i = _mm256_add_ps(_mm256_mul_ps(tmp, z_i), ci);
+				i = _mm256_sub_epi32(i, _mm256_castps_si256(active));
+				
+				__m256 norm = _mm256_add_ps(_mm256_mul_ps(z_r, z_r), _mm256_mul_ps(z_i, z_i));
+				active = _mm256_and_ps(active, _mm256_cmp_ps(norm, four, _CMP_LT_OQ));
+				active = _mm256_and_ps(active, _mm256_castsi256_ps(_mm256_cmpgt_epi32(limit, i)));
+				
+				if (CheckPeriod)
+				{
+					__m256 distance = _mm256_add_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(z_r, p_r)),
+													_mm256_andnot_ps(sign, _mm256_sub_ps(z_i, p_i)));
+					__m256 periodic = _mm256_and_ps(active, _mm256_cmp_ps(distance, tol, _CMP_LT_OQ));
+					i = _mm256_blendv_epi8(i, limit, _mm256_castps_si256(periodic));
+					active = _mm256_andnot_ps(periodic, active);
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (_mm256_movemask_ps(active));
+			
+			_mm256_storeu_si256((__m256i *)(iterations + x), i);
+		}
+		
+		if (x < count)
+			escapeTimeScalarFloat(c_r + x, c_i, count - x, resolution, tolerance, iterations + x);
+	}
+	
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("avx2,fma")
+	inline void escapeTime(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						   unsigned count, int resolution, double tolerance, int *iterations)
+	{
+		const __m256d one = _mm256_set1_pd(1.0);
+		const __m256d four = _mm256_set1_pd(4.0);
+		const __m256d limit = _mm256_set1_pd(resolution);
+		DoubleDouble4 ci;
+		ci.hi = _mm256_set1_pd(c_i.hi);
+		ci.lo = _mm256_set1_pd(c_i.lo);
+		const __m256d sign = _mm256_set1_pd(-0.0);
+		const __m256d tol = _mm256_set1_pd(tolerance);
+		unsigned x = 0;
+		
+		for (; x + 4 <= count; x += 4)
+		{
+			DoubleDouble4 cr;
+			cr.hi = _mm256_loadu_pd(c_r_hi + x);
+			cr.lo = _mm256_loadu_pd(c_r_lo + x);
+			DoubleDouble4 z_r = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+			DoubleDouble4 z_i = z_r;
+			__m256d i = _mm256_setzero_pd();
+			__m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+			DoubleDouble4 p_r = z_r;
+			DoubleDouble4 p_i = z_r;
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				DoubleDouble4 z_ri = mul(z_r, z_i);
+				z_ri.hi = _mm256_add_pd(z_ri.hi, z_ri.hi);
+				z_ri.lo = _mm256_add_pd(z_ri.lo, z_ri.lo);
+				
+				z_r = add(add(sqr(z_r), negate(sqr(z_i))), cr);
+				z_i = add(z_ri, ci);
+				i = _mm256_add_pd(i, _mm256_and_pd(active, one));
+				
+				__m256d norm = _mm256_add_pd(_mm256_mul_pd(z_r.hi, z_r.hi), _mm256_mul_pd(z_i.hi, z_i.hi));
+				active = _mm256_and_pd(active, _mm256_cmp_pd(norm, four, _CMP_LT_OQ));
+				active = _mm256_and_pd(active, _mm256_cmp_pd(i, limit, _CMP_LT_OQ));
+				
+				if (CheckPeriod)
+				{
+					__m256d d_r = _mm256_add_pd(_mm256_sub_pd(z_r.hi, p_r.hi), _mm256_sub_pd(z_r.lo, p_r.lo));
+					__m256d d_i = _mm256_add_pd(_mm256_sub_pd(z_i.hi, p_i.hi), _mm256_sub_pd(z_i.lo, p_i.lo));
+					__m256d distance = _mm256_add_pd(_mm256_andnot_pd(sign, d_r), _mm256_andnot_pd(sign, d_i));
+					__m256d periodic = _mm256_and_pd(active, _mm256_cmp_pd(distance, tol, _CMP_LT_OQ));
+					i = _mm256_blendv_pd(i, limit, periodic);
+					active = _mm256_andnot_pd(periodic, active);
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (_mm256_movemask_pd(active));
+			
+			_mm_storeu_si128((__m128i *)(iterations + x), _mm256_cvtpd_epi32(i));
+		}
+		
+		if (x < count)
+			escapeTimeScalarDD(c_r_hi + x, c_r_lo + x, c_i, count - x, resolution, tolerance, iterations + x);
+	}
+}
+
+// Iterates four pixels in lockstep, one per double lane. Escaped lanes keep
+// being iterated but their counter is frozen by the 'active' mask, and the
+// loop ends once no lane is active anymore. Multiplications and additions
+// are deliberately not fused so that the results match escapeTimeScalar()
+// bit for bit.
+FRACTAL_TARGET("avx2")
+void escapeTimeAVX2(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+// Eight lane version of escapeTimeSSE2Float()
+FRACTAL_TARGET("avx2")
+void escapeTimeAVX2Float(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+// Four lane version of escapeTimeScalarDD()
+FRACTAL_TARGET("avx2,fma")
+void escapeTimeAVX2DD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+					  unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, iterations);
+}
+
+#endif
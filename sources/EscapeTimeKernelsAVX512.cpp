@@ -0,0 +1,332 @@
+
+/*
+ *  EscapeTimeKernelsAVX512.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "EscapeTimeKernels.hpp"
+
+#ifdef FRACTAL_X86_KERNELS
+
+#include <immintrin.h>
+
+// AVX-512 implies FMA, and GCC would otherwise fuse the multiplications and
+// additions below, which changes the iteration counts of long orbits
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+namespace {
+	// Eight double-doubles, see DoubleDouble.hpp for the scalar operations
+	struct DoubleDouble8 {
+		__m512d hi;
+		__m512d lo;
+	};
+	
+	FRACTAL_TARGET("avx512f")
+	inline DoubleDouble8 quickTwoSum(__m512d a, __m512d b)
+	{
+		DoubleDouble8 r;
+		r.hi = _mm512_add_pd(a, b);
+		r.lo = _mm512_sub_pd(b, _mm512_sub_pd(r.hi, a));
+		return r;
+	}
+	
+	FRACTAL_TARGET("avx512f")
+	inline DoubleDouble8 add(const DoubleDouble8& a, const DoubleDouble8& b)
+	{
+		__m512d s = _mm512_add_pd(a.hi, b.hi);
+		__m512d bb = _mm512_sub_pd(s, a.hi);
+		__m512d e = _mm512_add_pd(_mm512_sub_pd(a.hi, _mm512_sub_pd(s, bb)), _mm512_sub_pd(b.hi, bb));
+		return quickTwoSum(s, _mm512_add_pd(e, _mm512_add_pd(a.lo, b.lo)));
+	}
+	
+	FRACTAL_TARGET("avx512f")
+	inline DoubleDouble8 negate(const DoubleDouble8& a)
+	{
+		const __m512i sign = _mm512_set1_epi64(0x8000000000000000ULL);
+		DoubleDouble8 r;
+		r.hi = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.hi), sign));
+		r.lo = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.lo), sign));
+		return r;
+	}
+	
+	FRACTAL_TARGET("avx512f")
+	inline DoubleDouble8 mul(const DoubleDouble8& a, const DoubleDouble8& b)
+	{
+		__m512d p = _mm512_mul_pd(a.hi, b.hi);
+		__m512d e = _mm512_fmsub_pd(a.hi, b.hi, p);
+		__m512d t = _mm512_add_pd(_mm512_mul_pd(a.hi, b.lo), _mm512_mul_pd(a.lo, b.hi));
+		return quickTwoSum(p, _mm512_add_pd(e, t));
+	}
+	
+	FRACTAL_TARGET("avx512f")
+	inline DoubleDouble8 sqr(const DoubleDouble8& a)
+	{
+		__m512d p = _mm512_mul_pd(a.hi, a.hi);
+		__m512d e = _mm512_fmsub_pd(a.hi, a.hi, p);
+		__m512d t = _mm512_mul_pd(_mm512_add_pd(a.hi, a.hi), a.lo);
+		return quickTwoSum(p, _mm512_add_pd(e, t));
+	}
+	
+	// Lane by lane isInMainCardioidOrBulb(), given c_i^2
+	FRACTAL_TARGET("avx512f")
+	inline __mmask8 mainCardioidOrBulbMask(__m512d cr, __m512d ci2)
+	{
+		const __m512d quarter = _mm512_set1_pd(0.25);
+		__m512d x = _mm512_sub_pd(cr, quarter);
+		__m512d q = _mm512_add_pd(_mm512_mul_pd(x, x), ci2);
+		__m512d b = _mm512_add_pd(cr, _mm512_set1_pd(1.0));
+		return _mm512_cmp_pd_mask(_mm512_mul_pd(q, _mm512_add_pd(q, x)), _mm512_mul_pd(quarter, ci2), _CMP_LE_OQ)
+			| _mm512_cmp_pd_mask(_mm512_add_pd(_mm512_mul_pd(b, b), ci2), _mm512_set1_pd(0.0625), _CMP_LE_OQ);
+	}
+	
+	FRACTAL_TARGET("avx512f")
+	inline __mmask16 mainCardioidOrBulbMask(__m512 cr, __m512 ci2)
+	{
+		const __m512 quarter = _mm512_set1_ps(0.25f);
+		__m512 x = _mm512_sub_ps(cr, quarter);
+		__m512 q = _mm512_add_ps(_mm512_mul_ps(x, x), ci2);
+		__m512 b = _mm512_add_ps(cr, _mm512_set1_ps(1.0f));
+		return _mm512_cmp_ps_mask(_mm512_mul_ps(q, _mm512_add_ps(q, x)), _mm512_mul_ps(quarter, ci2), _CMP_LE_OQ)
+			| _mm512_cmp_ps_mask(_mm512_add_ps(_mm512_mul_ps(b, b), ci2), _mm512_set1_ps(0.0625f), _CMP_LE_OQ);
+	}
+	
+	// See the SSE2 kernels for the periodicity checking in lockstep
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("avx512f")
+	inline void escapeTime(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+	{
+		const __m512d one = _mm512_set1_pd(1.0);
+		const __m512d four = _mm512_set1_pd(4.0);
+		const __m512d limit = _mm512_set1_pd(resolution);
+		const __m512d ci = _mm512_set1_pd(c_i);
+		const __m512d ci2 = _mm512_set1_pd(c_i * c_i);
+		const __m512d tol = _mm512_set1_pd(tolerance);
+		
+		for (unsigned x = 0; x < count; x += 8)
+		{
+			const __mmask8 lanes = (count - x >= 8) ? 0xff : (__mmask8)((1 << (count - x)) - 1);
+			const __m512d cr = _mm512_maskz_loadu_pd(lanes, c_r + x);
+			__m512d z_r = _mm512_setzero_pd();
+			__m512d z_i = _mm512_setzero_pd();
+			const __mmask8 inside = mainCardioidOrBulbMask(cr, ci2);
+			__m512d i = _mm512_maskz_mov_pd(inside, limit);
+			__mmask8 active = lanes & ~inside;
+			__m512d p_r = _mm512_setzero_pd();
+			__m512d p_i = _mm512_setzero_pd();
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				__m512d z_r2 = _mm512_mul_pd(z_r, z_r);
+				__m512d z_i2 = _mm512_mul_pd(z_i, z_i);
+				__m512d tmp = _mm512_add_pd(z_r, z_r);
+				
+				z_r = _mm512_add_pd(_mm512_sub_pd(z_r2, z_i2), cr);
+				z_i = _mm512_add_pd(_mm512_mul_pd(tmp, z_i), ci);
+				i = _mm512_mask_add_pd(i, active, i, one);
+				
+				__m512d norm = _mm512_add_pd(_mm512_mul_pd(z_r, z_r), _mm512_mul_pd(z_i, z_i));
+				active = _mm512_mask_cmp_pd_mask(active, norm, four, _CMP_LT_OQ);
+				active = _mm512_mask_cmp_pd_mask(active, i, limit, _CMP_LT_OQ);
+				
+				if (CheckPeriod)
+				{
+					__m512d distance = _mm512_add_pd(_mm512_abs_pd(_mm512_sub_pd(z_r, p_r)),
+													 _mm512_abs_pd(_mm512_sub_pd(z_i, p_i)));
+					__mmask8 periodic = _mm512_mask_cmp_pd_mask(active, distance, tol, _CMP_LT_OQ);
+					i = _mm512_mask_mov_pd(i, periodic, limit);
+					active &= ~periodic;
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (active);
+			
+			_mm512_mask_storeu_epi32(iterations + x, lanes, _mm512_castsi256_si512(_mm512_maskz_cvtpd_epi32(lanes, i)));
+		}
+	}
+	
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("avx512f")
+	inline void escapeTime(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+	{
+		const __m512 four = _mm512_set1_ps(4.0f);
+		const __m512i one = _mm512_set1_epi32(1);
+		const __m512i limit = _mm512_set1_epi32(resolution);
+		const __m512 ci = _mm512_set1_ps(c_i);
+		const __m512 ci2 = _mm512_set1_ps(c_i * c_i);
+		const __m512 tol = _mm512_set1_ps(tolerance);
+		
+		for (unsigned x = 0; x < count; x += 16)
+		{
+			const __mmask16 lanes = (count - x >= 16) ? 0xffff : (__mmask16)((1 << (count - x)) - 1);
+			const __m512 cr = _mm512_maskz_loadu_ps(lanes, c_r + x);
+			__m512 z_r = _mm512_setzero_ps();
+			__m512 z_i = _mm512_setzero_ps();
+			const __mmask16 inside = mainCardioidOrBulbMask(cr, ci2);
+			__m512i i = _mm512_maskz_mov_epi32(inside, limit);
+			__mmask16 active = lanes & ~inside;
+			__m512 p_r = _mm512_setzero_ps();
+			__m512 p_i = _mm512_setzero_ps();
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				__m512 z_r2 = _mm512_mul_ps(z_r, z_r);
+				__m512 z_i2 = _mm512_mul_ps(z_i, z_i);
+				__m512 tmp = _mm512_add_ps(z_r, z_r);
+				
+				z_r = _mm512_add_ps(_mm512_sub_ps(z_r2, z_i2), cr);
+				z_i = _mm512_add_ps(_mm512_mul_ps(tmp, z_i), ci);
+				i = _mm512_mask_add_epi32(i, active, i, one);
+				
+				__m512 norm = _mm512_add_ps(_mm512_mul_ps(z_r, z_r), _mm512_mul_ps(z_i, z_i));
+				active = _mm512_mask_cmp_ps_mask(active, norm, four, _CMP_LT_OQ);
+				active = _mm512_mask_cmplt_epi32_mask(active, i, limit);
+				
+				if (CheckPeriod)
+				{
+					__m512 distance = _mm512_add_ps(_mm512_abs_ps(_mm512_sub_ps(z_r, p_r)),
+													_mm512_abs_ps(_mm512_sub_ps(z_i, p_i)));
+					__mmask16 periodic = _mm512_mask_cmp_ps_mask(active, distance, tol, _CMP_LT_OQ);
+					i = _mm512_mask_mov_epi32(i, periodic, limit);
+					active &= ~periodic;
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (active);
+			
+			_mm512_mask_storeu_epi32(iterations + x, lanes, i);
+		}
+	}
+	
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("avx512f")
+	inline void escapeTime(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						   unsigned count, int resolution, double tolerance, int *iterations)
+	{
+		const __m512d one = _mm512_set1_pd(1.0);
+		const __m512d four = _mm512_set1_pd(4.0);
+		const __m512d limit = _mm512_set1_pd(resolution);
+		DoubleDouble8 ci;
+		ci.hi = _mm512_set1_pd(c_i.hi);
+		ci.lo = _mm512_set1_pd(c_i.lo);
+		const __m512d tol = _mm512_set1_pd(tolerance);
+		
+		for (unsigned x = 0; x < count; x += 8)
+		{
+			const __mmask8 lanes = (count - x >= 8) ? 0xff : (__mmask8)((1 << (count - x)) - 1);
+			DoubleDouble8 cr;
+			cr.hi = _mm512_maskz_loadu_pd(lanes, c_r_hi + x);
+			cr.lo = _mm512_maskz_loadu_pd(lanes, c_r_lo + x);
+			DoubleDouble8 z_r = {_mm512_setzero_pd(), _mm512_setzero_pd()};
+			DoubleDouble8 z_i = z_r;
+			__m512d i = _mm512_setzero_pd();
+			__mmask8 active = lanes;
+			DoubleDouble8 p_r = z_r;
+			DoubleDouble8 p_i = z_r;
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				DoubleDouble8 z_ri = mul(z_r, z_i);
+				z_ri.hi = _mm512_add_pd(z_ri.hi, z_ri.hi);
+				z_ri.lo = _mm512_add_pd(z_ri.lo, z_ri.lo);
+				
+				z_r = add(add(sqr(z_r), negate(sqr(z_i))), cr);
+				z_i = add(z_ri, ci);
+				i = _mm512_mask_add_pd(i, active, i, one);
+				
+				__m512d norm = _mm512_add_pd(_mm512_mul_pd(z_r.hi, z_r.hi), _mm512_mul_pd(z_i.hi, z_i.hi));
+				active = _mm512_mask_cmp_pd_mask(active, norm, four, _CMP_LT_OQ);
+				active = _mm512_mask_cmp_pd_mask(active, i, limit, _CMP_LT_OQ);
+				
+				if (CheckPeriod)
+				{
+					__m512d d_r = _mm512_add_pd(_mm512_sub_pd(z_r.hi, p_r.hi), _mm512_sub_pd(z_r.lo, p_r.lo));
+					__m512d d_i = _mm512_add_pd(_mm512_sub_pd(z_i.hi, p_i.hi), _mm512_sub_pd(z_i.lo, p_i.lo));
+					__m512d distance = _mm512_add_pd(_mm512_abs_pd(d_r), _mm512_abs_pd(d_i));
+					__mmask8 periodic = _mm512_mask_cmp_pd_mask(active, distance, tol, _CMP_LT_OQ);
+					i = _mm512_mask_mov_pd(i, periodic, limit);
+					active &= ~periodic;
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (active);
+			
+			_mm512_mask_storeu_epi32(iterations + x, lanes, _mm512_castsi256_si512(_mm512_maskz_cvtpd_epi32(lanes, i)));
+		}
+	}
+}
+
+// Eight lane version of escapeTimeAVX2(). The lane masks live in mask
+// registers, which also lets the last pixels of the run be handled with
+// partially filled vectors instead of falling back to the scalar kernel.
+FRACTAL_TARGET("avx512f")
+void escapeTimeAVX512(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+// Sixteen lane version of escapeTimeSSE2Float()
+FRACTAL_TARGET("avx512f")
+void escapeTimeAVX512Float(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+// Eight lane version of escapeTimeScalarDD()
+FRACTAL_TARGET("avx512f")
+void escapeTimeAVX512DD(const double *c_r_hi, const double *c_r_lo, DoubleDouble c_i,
+						unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r_hi, c_r_lo, c_i, count, resolution, tolerance, iterations);
+}
+
+#endif
@@ -0,0 +1,210 @@
+
+/*
+ *  EscapeTimeKernelsSSE2.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "EscapeTimeKernels.hpp"
+
+#ifdef FRACTAL_X86_KERNELS
+
+#include <emmintrin.h>
+
+namespace {
+	// Lane by lane isInMainCardioidOrBulb(), given c_i^2
+	FRACTAL_TARGET("sse2")
+	inline __m128d mainCardioidOrBulbMask(__m128d cr, __m128d ci2)
+	{
+		const __m128d quarter = _mm_set1_pd(0.25);
+		__m128d x = _mm_sub_pd(cr, quarter);
+		__m128d q = _mm_add_pd(_mm_mul_pd(x, x), ci2);
+		__m128d b = _mm_add_pd(cr, _mm_set1_pd(1.0));
+		__m128d cardioid = _mm_cmple_pd(_mm_mul_pd(q, _mm_add_pd(q, x)), _mm_mul_pd(quarter, ci2));
+		__m128d bulb = _mm_cmple_pd(_mm_add_pd(_mm_mul_pd(b, b), ci2), _mm_set1_pd(0.0625));
+		return _mm_or_pd(cardioid, bulb);
+	}
+	
+	FRACTAL_TARGET("sse2")
+	inline __m128 mainCardioidOrBulbMask(__m128 cr, __m128 ci2)
+	{
+		const __m128 quarter = _mm_set1_ps(0.25f);
+		__m128 x = _mm_sub_ps(cr, quarter);
+		__m128 q = _mm_add_ps(_mm_mul_ps(x, x), ci2);
+		__m128 b = _mm_add_ps(cr, _mm_set1_ps(1.0f));
+		__m128 cardioid = _mm_cmple_ps(_mm_mul_ps(q, _mm_add_ps(q, x)), _mm_mul_ps(quarter, ci2));
+		__m128 bulb = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(b, b), ci2), _mm_set1_ps(0.0625f));
+		return _mm_or_ps(cardioid, bulb);
+	}
+	
+	// The lanes are all iterated in lockstep, so the lane counters that are
+	// still running are all equal to the loop counter 'n' and z is saved at the
+	// same time in every lane
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("sse2")
+	inline void escapeTime(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+	{
+		const __m128d one = _mm_set1_pd(1.0);
+		const __m128d four = _mm_set1_pd(4.0);
+		const __m128d limit = _mm_set1_pd(resolution);
+		const __m128d ci = _mm_set1_pd(c_i);
+		const __m128d ci2 = _mm_set1_pd(c_i * c_i);
+		const __m128d sign = _mm_set1_pd(-0.0);
+		const __m128d tol = _mm_set1_pd(tolerance);
+		unsigned x = 0;
+		
+		for (; x + 2 <= count; x += 2)
+		{
+			const __m128d cr = _mm_loadu_pd(c_r + x);
+			__m128d z_r = _mm_setzero_pd();
+			__m128d z_i = _mm_setzero_pd();
+			const __m128d inside = mainCardioidOrBulbMask(cr, ci2);
+			__m128d i = _mm_and_pd(inside, limit);
+			__m128d active = _mm_andnot_pd(inside, _mm_castsi128_pd(_mm_set1_epi32(-1)));
+			__m128d p_r = _mm_setzero_pd();
+			__m128d p_i = _mm_setzero_pd();
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				__m128d z_r2 = _mm_mul_pd(z_r, z_r);
+				__m128d z_i2 = _mm_mul_pd(z_i, z_i);
+				__m128d tmp = _mm_add_pd(z_r, z_r);
+				
+				z_r = _mm_add_pd(_mm_sub_pd(z_r2, z_i2), cr);
+				z_i = _mm_add_pd(_mm_mul_pd(tmp, z_i), ci);
+				i = _mm_add_pd(i, _mm_and_pd(active, one));
+				
+				__m128d norm = _mm_add_pd(_mm_mul_pd(z_r, z_r), _mm_mul_pd(z_i, z_i));
+				active = _mm_and_pd(active, _mm_cmplt_pd(norm, four));
+				active = _mm_and_pd(active, _mm_cmplt_pd(i, limit));
+				
+				if (CheckPeriod)
+				{
+					__m128d distance = _mm_add_pd(_mm_andnot_pd(sign, _mm_sub_pd(z_r, p_r)),
+												  _mm_andnot_pd(sign, _mm_sub_pd(z_i, p_i)));
+					__m128d periodic = _mm_and_pd(active, _mm_cmplt_pd(distance, tol));
+					i = _mm_or_pd(_mm_andnot_pd(periodic, i), _mm_and_pd(periodic, limit));
+					active = _mm_andnot_pd(periodic, active);
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (_mm_movemask_pd(active));
+			
+			_mm_storel_epi64((__m128i *)(iterations + x), _mm_cvtpd_epi32(i));
+		}
+		
+		if (x < count)
+			escapeTimeScalar(c_r + x, c_i, count - x, resolution, tolerance, iterations + x);
+	}
+	
+	template <bool CheckPeriod>
+	FRACTAL_TARGET("sse2")
+	inline void escapeTime(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+	{
+		const __m128 four = _mm_set1_ps(4.0f);
+		const __m128i limit = _mm_set1_epi32(resolution);
+		const __m128 ci = _mm_set1_ps(c_i);
+		const __m128 ci2 = _mm_set1_ps(c_i * c_i);
+		const __m128 sign = _mm_set1_ps(-0.0f);
+		const __m128 tol = _mm_set1_ps(tolerance);
+		unsigned x = 0;
+		
+		for (; x + 4 <= count; x += 4)
+		{
+			const __m128 cr = _mm_loadu_ps(c_r + x);
+			__m128 z_r = _mm_setzero_ps();
+			__m128 z_i = _mm_setzero_ps();
+			const __m128 inside = mainCardioidOrBulbMask(cr, ci2);
+			__m128i i = _mm_and_si128(_mm_castps_si128(inside), limit);
+			__m128 active = _mm_andnot_ps(inside, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+			__m128 p_r = _mm_setzero_ps();
+			__m128 p_i = _mm_setzero_ps();
+			int checkpoint = 1;
+			int n = 0;
+			
+			do {
+				__m128 z_r2 = _mm_mul_ps(z_r, z_r);
+				__m128 z_i2 = _mm_mul_ps(z_i, z_i);
+				__m128 tmp = _mm_add_ps(z_r, z_r);
+				
+				z_r = _mm_add_ps(_mm_sub_ps(z_r2, z_i2), cr);
+				z_i = _mm_add_ps(_mm_mul_ps(tmp, z_i), ci);
+				i = _mm_sub_epi32(i, _mm_castps_si128(active));
+				
+				__m128 norm = _mm_add_ps(_mm_mul_ps(z_r, z_r), _mm_mul_ps(z_i, z_i));
+				active = _mm_and_ps(active, _mm_cmplt_ps(norm, four));
+				active = _mm_and_ps(active, _mm_castsi128_ps(_mm_cmplt_epi32(i, limit)));
+				
+				if (CheckPeriod)
+				{
+					__m128 distance = _mm_add_ps(_mm_andnot_ps(sign, _mm_sub_ps(z_r, p_r)),
+												 _mm_andnot_ps(sign, _mm_sub_ps(z_i, p_i)));
+					__m128i periodic = _mm_castps_si128(_mm_and_ps(active, _mm_cmplt_ps(distance, tol)));
+					i = _mm_or_si128(_mm_andnot_si128(periodic, i), _mm_and_si128(periodic, limit));
+					active = _mm_andnot_ps(_mm_castsi128_ps(periodic), active);
+					
+					if (++n == checkpoint)
+					{
+						p_r = z_r;
+						p_i = z_i;
+						checkpoint *= 2;
+					}
+				}
+			} while (_mm_movemask_ps(active));
+			
+			_mm_storeu_si128((__m128i *)(iterations + x), i);
+		}
+		
+		if (x < count)
+			escapeTimeScalarFloat(c_r + x, c_i, count - x, resolution, tolerance, iterations + x);
+	}
+}
+
+// Two lane version of escapeTimeAVX2()
+FRACTAL_TARGET("sse2")
+void escapeTimeSSE2(const double *c_r, double c_i, unsigned count, int resolution, double tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+// Four float lanes. The counters are kept as integers since floats can only
+// count exactly up to 2^24 iterations.
+FRACTAL_TARGET("sse2")
+void escapeTimeSSE2Float(const float *c_r, float c_i, unsigned count, int resolution, float tolerance, int *iterations)
+{
+	if (tolerance > 0)
+		escapeTime<true>(c_r, c_i, count, resolution, tolerance, iterations);
+	else
+		escapeTime<false>(c_r, c_i, count, resolution, tolerance, iterations);
+}
+
+#endif
@@ -0,0 +1,231 @@
+
+/*
+ *  FloatExp.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef FLOAT_EXP_HPP
+#define FLOAT_EXP_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include "BigFloat.hpp"
+
+// Double mantissa in [1, 2) with a separate 64 bits exponent, for values far
+// beyond the range of doubles: pixel spacings and offsets past zooms of 1e300.
+// Normalizing only takes bit operations on the mantissa, without branches or
+// calls to the math library, so that loops over floatexps can be vectorized.
+class FloatExp {
+public:
+	// Exponent of 0, low enough for 0 to vanish when added to anything, and
+	// high enough not to overflow when multiplied
+	static const int64_t zeroExponent = -(INT64_C(1) << 52);
+	
+	FloatExp(void) : mantissa(0), exponent(zeroExponent) {}
+	
+	FloatExp(double value) : mantissa(0), exponent(zeroExponent)
+	{
+		if (value != 0)
+		{
+			int e;
+			mantissa = 2 * std::frexp(value, &e);
+			exponent = e - 1;
+		}
+	}
+	
+	// 'value' must not be a subnormal double
+	FloatExp(double value, int64_t valueExponent) : mantissa(value), exponent(valueExponent)
+	{
+		normalize();
+	}
+	
+	void normalize(void)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &mantissa, sizeof(bits));
+		int64_t biased = (bits >> 52) & 0x7ff;
+		bool zero = (biased == 0);
+		
+		bits = (bits & UINT64_C(0x800fffffffffffff)) | (zero ? 0 : UINT64_C(0x3ff0000000000000));
+		std::memcpy(&mantissa, &bits, sizeof(bits));
+		exponent = zero ? zeroExponent : exponent + biased - 1023;
+	}
+	
+	double toDouble(void) const
+	{
+		return std::ldexp(mantissa, (int)std::max<int64_t>(std::min<int64_t>(exponent, 2048), -2048));
+	}
+	
+	double mantissa;
+	int64_t exponent;
+};
+
+namespace FloatExpDetail {
+	// 2^e for e in the range of normal doubles, clamped to that range
+	inline double powerOfTwo(int64_t e)
+	{
+		uint64_t bits = (uint64_t)(std::max<int64_t>(std::min<int64_t>(e, 1023), -1022) + 1023) << 52;
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+inline FloatExp operator-(const FloatExp& a)
+{
+	FloatExp result = a;
+	result.mantissa = -a.mantissa;
+	return result;
+}
+
+// The smaller operand is aligned on the larger one, and simply vanishes when
+// it is more than 1022 binades below
+inline FloatExp operator+(const FloatExp& a, const FloatExp& b)
+{
+	const FloatExp& large = (a.exponent >= b.exponent) ? a : b;
+	const FloatExp& small = (a.exponent >= b.exponent) ? b : a;
+	return FloatExp(large.mantissa + small.mantissa * FloatExpDetail::powerOfTwo(small.exponent - large.exponent),
+					large.exponent);
+}
+
+inline FloatExp operator-(const FloatExp& a, const FloatExp& b)
+{
+	return a + -b;
+}
+
+inline FloatExp operator*(const FloatExp& a, const FloatExp& b)
+{
+	return FloatExp(a.mantissa * b.mantissa, a.exponent + b.exponent);
+}
+
+inline FloatExp operator*(const FloatExp& a, double b)
+{
+	return FloatExp(a.mantissa * b, a.exponent);
+}
+
+inline FloatExp operator*(double a, const FloatExp& b)
+{
+	return FloatExp(a * b.mantissa, b.exponent);
+}
+
+inline FloatExp operator/(const FloatExp& a, const FloatExp& b)
+{
+	return FloatExp(a.mantissa / b.mantissa, a.exponent - b.exponent);
+}
+
+inline FloatExp operator/(const FloatExp& a, double b)
+{
+	return FloatExp(a.mantissa / b, a.exponent);
+}
+
+// a * b + c * d + e, with a single normalization instead of one after each
+// operation: the products are left as the mantissas give them, in [1, 4),
+// and the three terms are aligned on the largest exponent before being
+// added. This is how the perturbation steps amortize the normalization.
+inline FloatExp multiplyAdd(const FloatExp& a, const FloatExp& b, const FloatExp& c, const FloatExp& d, const FloatExp& e)
+{
+	int64_t ab = a.exponent + b.exponent;
+	int64_t cd = c.exponent + d.exponent;
+	int64_t top = std::max(std::max(ab, cd), e.exponent);
+	
+	return FloatExp(a.mantissa * b.mantissa * FloatExpDetail::powerOfTwo(ab - top) +
+					c.mantissa * d.mantissa * FloatExpDetail::powerOfTwo(cd - top) +
+					e.mantissa * FloatExpDetail::powerOfTwo(e.exponent - top), top);
+}
+
+inline FloatExp& operator+=(FloatExp& a, const FloatExp& b)
+{
+	return a = a + b;
+}
+
+inline FloatExp& operator-=(FloatExp& a, const FloatExp& b)
+{
+	return a = a - b;
+}
+
+inline FloatExp& operator*=(FloatExp& a, const FloatExp& b)
+{
+	return a = a * b;
+}
+
+inline bool operator<(const FloatExp& a, const FloatExp& b)
+{
+	return (a - b).mantissa < 0;
+}
+
+inline bool operator>(const FloatExp& a, const FloatExp& b)
+{
+	return b < a;
+}
+
+inline FloatExp fabs(const FloatExp& a)
+{
+	FloatExp result = a;
+	result.mantissa = std::fabs(a.mantissa);
+	return result;
+}
+
+inline FloatExp hypot(const FloatExp& a, const FloatExp& b)
+{
+	int64_t e = std::max(a.exponent, b.exponent);
+	return FloatExp(std::hypot(a.mantissa * FloatExpDetail::powerOfTwo(a.exponent - e),
+							   b.mantissa * FloatExpDetail::powerOfTwo(b.exponent - e)), e);
+}
+
+inline FloatExp floor(const FloatExp& a)
+{
+	// Every double is an integer from 2^52 on
+	return (a.exponent >= 52) ? a : FloatExp(std::floor(a.toDouble()));
+}
+
+template <unsigned Limbs>
+BigFloat<Limbs> toBigFloat(const FloatExp& value)
+{
+	if (value.mantissa == 0)
+		return BigFloat<Limbs>();
+	
+	return ldexp(BigFloat<Limbs>(value.mantissa), (int)value.exponent);
+}
+
+// Printed as a double while in range, and in decimal scientific notation
+// beyond
+inline std::ostream& operator<<(std::ostream& stream, const FloatExp& value)
+{
+	if (value.mantissa == 0 || (value.exponent > -1000 && value.exponent < 1000))
+		return stream << value.toDouble();
+	
+	double digits = (value.exponent + std::log2(std::fabs(value.mantissa))) * std::log10(2.0);
+	double decimalExponent = std::floor(digits);
+	double decimalMantissa = std::pow(10.0, digits - decimalExponent);
+	
+	if (value.mantissa < 0)
+		decimalMantissa = -decimalMantissa;
+	
+	return stream << decimalMantissa << "e" << (int64_t)decimalExponent;
+}
+
+#endif
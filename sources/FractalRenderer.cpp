@@ -26,20 +26,42 @@
  */
 
 #include "FractalRenderer.hpp"
+#include "KernelRegistry.hpp"
+#include "BoundaryTracing.hpp"
+#include "MarianiSilver.hpp"
+#include "SolidGuessing.hpp"
+#include "Supersampling.hpp"
 #include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <vector>
 
 
 FractalRenderer::FractalRenderer(unsigned width, unsigned heigth) :
 m_data(NULL),
 m_texture(),
-m_normalizedPosition(0.4, 0.5),
-m_scale(1.0),
+m_viewport(width, heigth),
 m_resolution(30),
+m_precision(DoublePrecision),
+m_periodicityChecking(false),
+m_interiorProof(false),
+m_coloring(IterationColoring),
+m_renderingMode(PerPixelRendering),
+m_guessVerification(false),
+m_iterations(width * heigth),
+m_distances(width * heigth),
+m_supersampling(1),
+m_reference(),
 m_image_x(width),
 m_image_y(heigth),
 m_lastRenderingTime(sf::Time::Zero)
 {
+	m_viewport.setCenter(Vector2bf(-0.75, 0));
+	
 	m_data = new unsigned char[m_image_x * m_image_y * 4];
 	bzero(m_data, m_image_x * m_image_y * 4);
 	
@@ -61,26 +83,159 @@ FractalRenderer::~FractalRenderer()
 #include <cstdio>
 void FractalRenderer::performRendering(void)
 {
-	printf("data=%p, width=%d, heigth=%d, zoom=%f, resolution=%d, posx=%f, posy=%f\n",
-		   m_data, m_image_x, m_image_y, m_scale, m_resolution, m_normalizedPosition.x, m_normalizedPosition.y);
+	std::ostringstream zoom;
+	zoom << m_viewport.getZoom();
+	printf("data=%p, width=%d, heigth=%d, zoom=%s, resolution=%d, posx=%f, posy=%f\n",
+		   m_data, m_image_x, m_image_y, zoom.str().c_str(), m_resolution,
+		   m_viewport.getCenter().x.toDouble(), m_viewport.getCenter().y.toDouble());
 	
 	sf::Clock timer;
-	parallel_for(tbb::blocked_range2d<unsigned, unsigned>(0, m_image_x, 50, 0, m_image_y, 50),
-				 MandelbrotRenderer(m_data, m_image_x, m_image_y, m_scale, m_resolution, m_normalizedPosition));
+	MandelbrotRenderer renderer(m_data, m_viewport, m_resolution, KernelRegistry::getSelected());
+	
+	m_precision = selectPrecision(renderer);
+	renderer.setPrecision(m_precision);
+	renderer.setPeriodicityChecking(m_periodicityChecking);
+	renderer.setInteriorProof(m_interiorProof);
+	renderer.setColoring(m_coloring);
+	
+	if (m_precision == PerturbationPrecision || m_precision == ExtendedPerturbationPrecision)
+	{
+		m_reference.compute(renderer, renderer.getReferencePoint(),
+							sf::Vector2u(0, 0), sf::Vector2u(m_image_x - 1, m_image_y - 1));
+		renderer.setPerturbation(m_reference);
+	}
+	
+	// When the real axis crosses the view on the pixel lattice, only its larger
+	// side is rendered, and the other side copied from it
+	unsigned mirror = 0;
+	unsigned top = 0;
+	unsigned bottom = m_image_y;
+	bool mirrored = renderer.isConjugateSymmetric() && m_viewport.getMirror(mirror);
+	
+	if (mirrored)
+	{
+		if ((mirror + 1) / 2 >= m_image_y - (mirror / 2 + 1))
+			bottom = mirror / 2 + 1;
+		else
+			top = (mirror + 1) / 2;
+	}
+	
+	// The pixels near the boundary are sampled again once all are rendered,
+	// which needs the iteration counts and distance estimates of all of them
+	bool supersampled = m_supersampling > 1 && renderer.hasDistanceEstimates();
+	
+	if (supersampled)
+	{
+		std::fill(m_distances.begin(), m_distances.end(), FLT_MAX);
+		renderer.setIterationBuffer(&m_iterations[0]);
+		renderer.setDistanceBuffer(&m_distances[0]);
+	}
+	
+	switch (m_renderingMode) {
+		case SubdivisionRendering:
+			renderer.setIterationBuffer(&m_iterations[0]);
+			MarianiSilver(renderer, m_data, &m_iterations[0], top, bottom).render();
+			break;
+			
+		case BoundaryTracingRendering:
+			renderer.setIterationBuffer(&m_iterations[0]);
+			BoundaryTracing(renderer, m_data, &m_iterations[0], top, bottom).render();
+			break;
+			
+		case SolidGuessingRendering:
+			renderer.setIterationBuffer(&m_iterations[0]);
+			SolidGuessing(renderer, m_data, &m_iterations[0], top, bottom, m_guessVerification).render();
+			break;
+			
+		default:
+			parallel_for(tbb::blocked_range2d<unsigned, unsigned>(0, m_image_x, 50, top, bottom, 50), renderer);
+			break;
+	}
+	
+	if (supersampled)
+		Supersampling(renderer, &m_iterations[0], &m_distances[0], top, bottom, m_supersampling).render();
+	
+	if (mirrored)
+	{
+		for (unsigned image_y = 0; image_y < (unsigned)m_image_y; image_y++)
+		{
+			if (image_y < top || image_y >= bottom)
+				std::memcpy(m_data + image_y * m_image_x * 4, m_data + (mirror - image_y) * m_image_x * 4, m_image_x * 4);
+		}
+	}
 	
 	m_texture.update(m_data);
 	m_lastRenderingTime = timer.getElapsedTime();
 }
 
-void FractalRenderer::setZoom(double zoom)
+Precision FractalRenderer::selectPrecision(const MandelbrotRenderer& renderer)
 {
-	m_scale = zoom;
+	// A precision is used as long as two neighbour pixels stay 'margin' steps
+	// of that precision apart, for the largest coordinate or orbit value
+	// involved. Floats get a larger margin as their rounding errors along the
+	// orbit become visible much sooner.
+	const double floatMargin = 1024;
+	const double doubleMargin = 16;
+	const double doubleDoubleMargin = 16;
+	const double quadDoubleMargin = 16;
+	const double doubleDoubleEpsilon = 4.93038065763132e-32; // 2^-104
+	const double quadDoubleEpsilon = 1.21543267145725e-63; // 2^-209
+	const double perturbationMinimumSpacing = 1e-290;
+	const Viewport& viewport = renderer.getViewport();
+	double spacing = viewport.getPixelSpacing().toDouble();
+	double magnitude = 2.0;
+	
+	// The largest coordinates are at the corners, whatever the rotation
+	for (unsigned corner = 0; corner < 4; corner++)
+	{
+		Vector2bf c = viewport.getCoordinates((corner & 1) ? m_image_x - 1 : 0, (corner & 2) ? m_image_y - 1 : 0);
+		magnitude = std::max(magnitude, std::max(fabs(c.x.toDouble()), fabs(c.y.toDouble())));
+	}
+	
+	if (spacing > floatMargin * FLT_EPSILON * magnitude)
+		return SinglePrecision;
+	
+	if (spacing > doubleMargin * DBL_EPSILON * magnitude)
+		return DoublePrecision;
+	
+	if (spacing > doubleDoubleMargin * doubleDoubleEpsilon * magnitude)
+		return DoubleDoublePrecision;
+	
+	if (spacing > quadDoubleMargin * quadDoubleEpsilon * magnitude)
+		return QuadDoublePrecision;
+	
+	// Offsets from the reference point must stay far enough from the double
+	// underflow for the series approximation to multiply them
+	if (viewport.getPixelSpacing() > FloatExp(perturbationMinimumSpacing))
+		return PerturbationPrecision;
+	
+	return ExtendedPerturbationPrecision;
+}
+
+
+void FractalRenderer::setZoom(const FloatExp& zoom)
+{
+	m_viewport.setZoom(zoom);
+}
+
+
+void FractalRenderer::setCenter(const Vector2bf& center)
+{
+	m_viewport.setCenter(center);
+}
+
+
+void FractalRenderer::setRotation(double rotation)
+{
+	m_viewport.setRotation(rotation);
 }
 
 
-void FractalRenderer::setNormalizedPosition(Vector2lf normalizedPosition)
+// The center is moved by the viewport so that it keeps more precision than
+// a double can hold
+void FractalRenderer::moveView(Vector2lf pixels)
 {
-	m_normalizedPosition = normalizedPosition;
+	m_viewport.move(pixels);
 }
 
 
@@ -90,15 +245,59 @@ void FractalRenderer::setResolution(int resolution)
 }
 
 
-double FractalRenderer::getZoom(void)
+void FractalRenderer::setPeriodicityChecking(bool enabled)
 {
-	return m_scale;
+	m_periodicityChecking = enabled;
 }
 
 
-const Vector2lf& FractalRenderer::getNormalizedPosition(void)
+void FractalRenderer::setColoring(Coloring coloring)
 {
-	return m_normalizedPosition;
+	m_coloring = coloring;
+}
+
+
+void FractalRenderer::setRenderingMode(RenderingMode mode)
+{
+	m_renderingMode = mode;
+}
+
+
+void FractalRenderer::setInteriorProof(bool enabled)
+{
+	m_interiorProof = enabled;
+}
+
+
+// Only used by the solid guessing
+void FractalRenderer::setGuessVerification(bool enabled)
+{
+	m_guessVerification = enabled;
+}
+
+
+// 'samples' by 'samples' points for the pixels near the boundary, 1 for none
+void FractalRenderer::setSupersampling(unsigned samples)
+{
+	m_supersampling = samples;
+}
+
+
+FloatExp FractalRenderer::getZoom(void)
+{
+	return m_viewport.getZoom();
+}
+
+
+const Vector2bf& FractalRenderer::getCenter(void)
+{
+	return m_viewport.getCenter();
+}
+
+
+double FractalRenderer::getRotation(void)
+{
+	return m_viewport.getRotation();
 }
 
 
@@ -107,6 +306,41 @@ int FractalRenderer::getResolution(void)
 	return m_resolution;
 }
 
+bool FractalRenderer::getPeriodicityChecking(void)
+{
+	return m_periodicityChecking;
+}
+
+bool FractalRenderer::getInteriorProof(void)
+{
+	return m_interiorProof;
+}
+
+Coloring FractalRenderer::getColoring(void)
+{
+	return m_coloring;
+}
+
+RenderingMode FractalRenderer::getRenderingMode(void)
+{
+	return m_renderingMode;
+}
+
+bool FractalRenderer::getGuessVerification(void)
+{
+	return m_guessVerification;
+}
+
+unsigned FractalRenderer::getSupersampling(void)
+{
+	return m_supersampling;
+}
+
+Precision FractalRenderer::getPrecision(void)
+{
+	return m_precision;
+}
+
 const sf::Time& FractalRenderer::getLastRenderingTime(void)
 {
 	return m_lastRenderingTime;
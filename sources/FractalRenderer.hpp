@@ -30,6 +30,16 @@
 
 #include <SFML/Graphics.hpp>
 #include "MandelbrotRenderer.hpp"
+#include <vector>
+
+// Per-pixel rendering computes every pixel. The other modes guess some of
+// them from the iteration counts of their neighbours.
+enum RenderingMode {
+	PerPixelRendering,
+	SubdivisionRendering,
+	BoundaryTracingRendering,
+	SolidGuessingRendering
+};
 
 class FractalRenderer {
 public:
@@ -38,13 +48,29 @@ public:
 	
 	void performRendering(void);
 	
-	void setZoom(double zoom);
-	void setNormalizedPosition(Vector2lf normalizedPosition);
+	void setZoom(const FloatExp& zoom);
+	void setCenter(const Vector2bf& center);
+	void setRotation(double rotation);
+	void moveView(Vector2lf pixels);
 	void setResolution(int resolution);
+	void setPeriodicityChecking(bool enabled);
+	void setInteriorProof(bool enabled);
+	void setColoring(Coloring coloring);
+	void setRenderingMode(RenderingMode mode);
+	void setGuessVerification(bool enabled);
+	void setSupersampling(unsigned samples);
 	
-	double getZoom(void);
-	const Vector2lf& getNormalizedPosition(void);
+	FloatExp getZoom(void);
+	const Vector2bf& getCenter(void);
+	double getRotation(void);
 	int getResolution(void);
+	bool getPeriodicityChecking(void);
+	bool getInteriorProof(void);
+	Coloring getColoring(void);
+	RenderingMode getRenderingMode(void);
+	bool getGuessVerification(void);
+	unsigned getSupersampling(void);
+	Precision getPrecision(void);
 	const sf::Time& getLastRenderingTime(void);
 	
 	const sf::Texture& getTexture(void);
@@ -54,14 +80,24 @@ private:
 	unsigned m_dataSize;
 	sf::Texture m_texture;
 	
-	Vector2lf m_normalizedPosition;
-	double m_scale;
+	Viewport m_viewport;
 	int m_resolution;
+	Precision m_precision;
+	bool m_periodicityChecking;
+	bool m_interiorProof;
+	Coloring m_coloring;
+	RenderingMode m_renderingMode;
+	bool m_guessVerification;
+	std::vector<int> m_iterations;
+	std::vector<float> m_distances;
+	unsigned m_supersampling;
+	PerturbationReference m_reference;
 	int m_image_x;
 	int m_image_y;
 	
 	sf::Time m_lastRenderingTime;
 	
+	Precision selectPrecision(const MandelbrotRenderer& renderer);
 };
 
 #endif
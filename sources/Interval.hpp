@@ -0,0 +1,103 @@
+
+/*
+ *  Interval.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef INTERVAL_HPP
+#define INTERVAL_HPP
+
+#include <algorithm>
+#include <cmath>
+
+// Closed interval of doubles. Every operation rounds its bounds outwards,
+// one step past the rounded result, so that the result always contains the
+// exact result for any values taken in the operands.
+class Interval {
+public:
+	Interval(void) : lo(0), hi(0) {}
+	Interval(double value) : lo(value), hi(value) {}
+	Interval(double low, double high) : lo(low), hi(high) {}
+	
+	double lo;
+	double hi;
+};
+
+inline double roundDown(double value)
+{
+	return std::nextafter(value, -HUGE_VAL);
+}
+
+inline double roundUp(double value)
+{
+	return std::nextafter(value, HUGE_VAL);
+}
+
+inline Interval operator+(const Interval& a, const Interval& b)
+{
+	return Interval(roundDown(a.lo + b.lo), roundUp(a.hi + b.hi));
+}
+
+inline Interval operator-(const Interval& a, const Interval& b)
+{
+	return Interval(roundDown(a.lo - b.hi), roundUp(a.hi - b.lo));
+}
+
+inline Interval operator*(const Interval& a, const Interval& b)
+{
+	double p1 = a.lo * b.lo;
+	double p2 = a.lo * b.hi;
+	double p3 = a.hi * b.lo;
+	double p4 = a.hi * b.hi;
+	
+	return Interval(roundDown(std::min(std::min(p1, p2), std::min(p3, p4))),
+					roundUp(std::max(std::max(p1, p2), std::max(p3, p4))));
+}
+
+// Tighter than a * a, as both operands take the same value
+inline Interval sqr(const Interval& a)
+{
+	double l = a.lo * a.lo;
+	double h = a.hi * a.hi;
+	
+	if (a.lo >= 0)
+		return Interval(roundDown(l), roundUp(h));
+	
+	if (a.hi <= 0)
+		return Interval(roundDown(h), roundUp(l));
+	
+	return Interval(0, roundUp(std::max(l, h)));
+}
+
+inline bool contains(const Interval& outer, const Interval& inner)
+{
+	return outer.lo <= inner.lo && inner.hi <= outer.hi;
+}
+
+inline double magnitude(const Interval& a)
+{
+	return std::max(std::fabs(a.lo), std::fabs(a.hi));
+}
+
+#endif
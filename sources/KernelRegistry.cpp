@@ -0,0 +1,117 @@
+
+/*
+ *  KernelRegistry.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "KernelRegistry.hpp"
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+	bool alwaysSupported(void)
+	{
+		return true;
+	}
+	
+	const KernelRegistry::Entry entries[] = {
+		{"scalar", alwaysSupported, true, escapeTimeScalar, escapeTimeScalarFloat, escapeTimeScalarDD},
+		// The latency of the iterations themselves bounds the scalar loop, so
+		// skipping most escape tests only gains a few percents
+		{"batched", alwaysSupported, false, escapeTimeBatched, escapeTimeBatchedFloat, escapeTimeScalarDD},
+		// Default on hosts without SIMD kernels, about 1.5 times as fast as
+		// the scalar one there
+		{"interleaved", alwaysSupported, true, escapeTimeInterleaved, escapeTimeInterleavedFloat, escapeTimeScalarDD},
+#ifdef FRACTAL_X86_KERNELS
+		// Double-doubles need FMA to be worth vectorizing
+		{"sse2", cpuSupportsSSE2, true, escapeTimeSSE2, escapeTimeSSE2Float, escapeTimeScalarDD},
+		{"avx2", cpuSupportsAVX2, true, escapeTimeAVX2, escapeTimeAVX2Float, escapeTimeAVX2DD},
+		{"avx512", cpuSupportsAVX512, true, escapeTimeAVX512, escapeTimeAVX512Float, escapeTimeAVX512DD},
+#endif
+#ifdef FRACTAL_FIXED_POINT_KERNELS
+		// Only the double-double tier is in fixed point: at the zooms of that
+		// tier, it gives the same images on every host, which the
+		// double-double kernels cannot guarantee across compilers, but not
+		// the same ones as the other variants. The float and double tiers
+		// are the scalar kernels, and the deeper ones the common kernels.
+		{"fixed128", alwaysSupported, false, escapeTimeScalar, escapeTimeScalarFloat, escapeTimeFixed128},
+#endif
+	};
+	
+	const unsigned entryCount = sizeof(entries) / sizeof(entries[0]);
+}
+
+const KernelRegistry::Entry *KernelRegistry::m_selected = NULL;
+
+unsigned KernelRegistry::getEntryCount(void)
+{
+	return entryCount;
+}
+
+const KernelRegistry::Entry& KernelRegistry::getEntry(unsigned index)
+{
+	return entries[index];
+}
+
+const KernelRegistry::Entry& KernelRegistry::getSelected(void)
+{
+	if (m_selected == NULL)
+	{
+		const char *forced = getenv("FRACTAL_KERNEL");
+		
+		if (forced == NULL || !select(forced))
+		{
+			m_selected = &entries[0];
+			
+			for (unsigned i = 1; i < entryCount; i++)
+			{
+				if (entries[i].isDefaultCandidate && entries[i].isSupported())
+					m_selected = &entries[i];
+			}
+		}
+	}
+	
+	return *m_selected;
+}
+
+bool KernelRegistry::select(const std::string& name)
+{
+	for (unsigned i = 0; i < entryCount; i++)
+	{
+		if (name == entries[i].name)
+		{
+			if (!entries[i].isSupported())
+			{
+				std::cout << "the " << name << " kernel is not supported by this CPU" << std::endl;
+				return false;
+			}
+			
+			m_selected = &entries[i];
+			return true;
+		}
+	}
+	
+	std::cout << "unknown kernel " << name << std::endl;
+	return false;
+}
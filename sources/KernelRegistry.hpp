@@ -0,0 +1,60 @@
+
+/*
+ *  KernelRegistry.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef KERNEL_REGISTRY_HPP
+#define KERNEL_REGISTRY_HPP
+
+#include <string>
+#include "EscapeTimeKernels.hpp"
+
+// Every escape-time kernel variant compiled into the binary, from the
+// narrowest to the widest instruction set. By default the widest variant
+// the host supports is used. The FRACTAL_KERNEL environment variable or the
+// --kernel command line option can force another one, by name, including
+// the variants that are never picked by default.
+class KernelRegistry {
+public:
+	struct Entry {
+		const char *name;
+		bool (*isSupported)(void);
+		bool isDefaultCandidate;
+		EscapeTimeKernel kernel;
+		EscapeTimeKernelFloat floatKernel;
+		EscapeTimeKernelDD doubleDoubleKernel;
+	};
+	
+	static unsigned getEntryCount(void);
+	static const Entry& getEntry(unsigned index);
+	
+	static const Entry& getSelected(void);
+	static bool select(const std::string& name);
+	
+private:
+	static const Entry *m_selected;
+};
+
+#endif
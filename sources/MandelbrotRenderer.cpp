@@ -26,70 +26,574 @@
  */
 
 #include "MandelbrotRenderer.hpp"
+#include "Colorizers.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
 #include <iostream>
 #include <SFML/System.hpp>
 
-MandelbrotRenderer::MandelbrotRenderer(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
-									   double zoom, int resolution, const Vector2lf& normalizedPosition):
+namespace {
+	// Distance under which an orbit is taken as back to a previous value, in
+	// pixel spacings
+	const double periodicityTolerance = 1e-3;
+	
+	// Tiles narrower than this on either side are not worth a proof, which
+	// can cost as many iterations as a pixel when it fails
+	const unsigned proofMinimumSize = 8;
+	
+	// Iteration budget of the samples near the boundary, in resolutions: the
+	// points of the exterior there are the slowest to escape
+	const int samplingBudget = 4;
+}
+
+// Coordinates and results of a run of pixels sharing their imaginary part,
+// in the forms the kernels of every precision take
+struct MandelbrotRenderer::Run {
+	void resize(unsigned length);
+	
+	std::vector<double> c_r;
+	std::vector<double> c_r_lo;
+	std::vector<float> c_r_float;
+	std::vector<QuadDouble> c_r_quad;
+	std::vector<FloatExp> c_r_fe;
+	std::vector<int> iterations;
+	std::vector<double> z_r;
+	std::vector<double> z_i;
+	std::vector<double> dz_r;
+	std::vector<double> dz_i;
+	std::vector<double> minimumNorm;
+	PixelData data;
+};
+
+MandelbrotRenderer::MandelbrotRenderer(unsigned char *pixelBuffer, const Viewport& viewport, int resolution,
+									   const KernelRegistry::Entry& kernels):
 m_pixelBuffer(pixelBuffer),
-m_pixelBufferWidth(width),
-m_pixelBufferHeigth(heigth),
-m_zoom(zoom),
+m_pixelBufferWidth(viewport.getWidth()),
+m_pixelBufferHeigth(viewport.getHeight()),
+m_viewport(viewport),
+m_center(viewport.getCenter().x.toDouble(), viewport.getCenter().y.toDouble()),
+m_centerDD(viewport.getCenter().x.toDoubleDouble(), viewport.getCenter().y.toDoubleDouble()),
+m_centerQD(viewport.getCenter().x.toQuadDouble(), viewport.getCenter().y.toQuadDouble()),
 m_resolution(resolution),
-m_normalizedPosition(normalizedPosition)
+m_kernels(&kernels),
+m_precision(DoublePrecision),
+m_coloring(IterationColoring),
+m_periodicityChecking(false),
+m_interiorProof(false),
+m_reference(NULL),
+m_iterationBuffer(NULL),
+m_distanceBuffer(NULL),
+m_runs(new tbb::enumerable_thread_specific<Run>())
 {
 }
 
 
-void MandelbrotRenderer::operator()(const tbb::blocked_range2d<unsigned, unsigned>& range) const
+void MandelbrotRenderer::setPrecision(Precision precision)
 {
-	const double fractal_left = -2.1;
-	const double fractal_right = 0.6;
-	const double fractal_bottom = -1.2;
-	const double fractal_top = 1.2;
+	m_precision = precision;
+}
+
+
+Precision MandelbrotRenderer::getPrecision(void) const
+{
+	return m_precision;
+}
+
+
+void MandelbrotRenderer::setColoring(Coloring coloring)
+{
+	m_coloring = coloring;
+}
+
+
+// Whether two pixels with the same iteration count always get the same color
+bool MandelbrotRenderer::isColoredByIterations(void) const
+{
+	return m_coloring == IterationColoring || m_precision == PerturbationPrecision
+		|| m_precision == ExtendedPerturbationPrecision;
+}
+
+
+bool MandelbrotRenderer::isConjugateSymmetric(void) const
+{
+	if (m_precision == PerturbationPrecision || m_precision == ExtendedPerturbationPrecision)
+		return IterationColorizer::conjugateSymmetric;
 	
-	//double zoom_x = m_zoom * m_pixelBufferWidth / (fractal_right - fractal_left);
-	double zoom_y = m_zoom * m_pixelBufferHeigth / (fractal_top - fractal_bottom);
-	double zoom_x = zoom_y;
+	switch (m_coloring) {
+		case IterationColoring:	return IterationColorizer::conjugateSymmetric;
+		case SmoothColoring:	return SmoothColorizer::conjugateSymmetric;
+		case OrbitTrapColoring:	return OrbitTrapColorizer::conjugateSymmetric;
+		case LightingColoring:	return LightingColorizer::conjugateSymmetric;
+		case DistanceColoring:	return DistanceColorizer::conjugateSymmetric;
+	}
 	
-	int64_t fractal_width = m_pixelBufferWidth * m_zoom;
-	int64_t fractal_heigth = m_pixelBufferHeigth * m_zoom;
+	return false;
+}
+
+
+void MandelbrotRenderer::setPeriodicityChecking(bool enabled)
+{
+	m_periodicityChecking = enabled;
+}
+
+
+void MandelbrotRenderer::setInteriorProof(bool enabled)
+{
+	m_interiorProof = enabled;
+}
+
+
+void MandelbrotRenderer::setPerturbation(const PerturbationReference& reference)
+{
+	m_reference = &reference;
+}
+
+
+void MandelbrotRenderer::setIterationBuffer(int *iterations)
+{
+	m_iterationBuffer = iterations;
+}
+
+
+void MandelbrotRenderer::setDistanceBuffer(float *distances)
+{
+	m_distanceBuffer = distances;
+}
+
+
+// The perturbation kernels do not compute dz/dc
+bool MandelbrotRenderer::hasDistanceEstimates(void) const
+{
+	return m_precision != PerturbationPrecision && m_precision != ExtendedPerturbationPrecision;
+}
+
+
+void MandelbrotRenderer::operator()(const tbb::blocked_range2d<unsigned, unsigned>& range) const
+{
+	if (m_interiorProof && m_precision != SinglePrecision && isProvenInterior(range))
+	{
+		fillInterior(range);
+		return;
+	}
+	
+	std::vector<unsigned> columns;
 	
 	for (unsigned image_x = range.rows().begin(); image_x != range.rows().end(); image_x++)
+		columns.push_back(image_x);
+	
+	renderColumns(columns, range.cols().begin(), range.cols().end());
+}
+
+
+void MandelbrotRenderer::renderPixels(unsigned image_y, const std::vector<unsigned>& columns) const
+{
+	if (!columns.empty())
+		renderColumns(columns, image_y, image_y + 1);
+}
+
+
+// The coordinates of the tile are bounded by those of its corners, whatever
+// the rotation. The kernels compute them in their own precision, which only
+// differs from these doubles by a few roundings.
+bool MandelbrotRenderer::isProvenInterior(const tbb::blocked_range2d<unsigned, unsigned>& range) const
+{
+	if (range.rows().size() < proofMinimumSize || range.cols().size() < proofMinimumSize)
+		return false;
+	
+	sf::Vector2u center = m_viewport.getCenterPixel();
+	Interval c_r(DBL_MAX, -DBL_MAX);
+	Interval c_i(DBL_MAX, -DBL_MAX);
+	
+	for (unsigned corner = 0; corner < 4; corner++)
 	{
-		for (unsigned image_y = range.cols().begin(); image_y != range.cols().end(); image_y++)
+		unsigned image_x = (corner & 1) ? range.rows().end() - 1 : range.rows().begin();
+		unsigned image_y = (corner & 2) ? range.cols().end() - 1 : range.cols().begin();
+		Vector2fe offset = m_viewport.getOffset(center, image_x, image_y);
+		double r = m_center.x + offset.x.toDouble();
+		double i = m_center.y + offset.y.toDouble();
+		
+		c_r = Interval(std::min(c_r.lo, r), std::max(c_r.hi, r));
+		c_i = Interval(std::min(c_i.lo, i), std::max(c_i.hi, i));
+	}
+	
+	double margin_r = 8 * DBL_EPSILON * (magnitude(c_r) + std::fabs(m_center.x));
+	double margin_i = 8 * DBL_EPSILON * (magnitude(c_i) + std::fabs(m_center.y));
+	c_r = c_r - Interval(-margin_r, margin_r);
+	c_i = c_i - Interval(-margin_i, margin_i);
+	
+	return ::isProvenInterior(c_r, c_i, m_resolution);
+}
+
+
+// Every colorizer paints the inside of the set the same way
+void MandelbrotRenderer::fillInterior(const tbb::blocked_range2d<unsigned, unsigned>& range) const
+{
+	int resolution = m_resolution;
+	PixelData data(&resolution);
+	
+	for (unsigned image_y = range.cols().begin(); image_y != range.cols().end(); image_y++)
+	{
+		for (unsigned image_x = range.rows().begin(); image_x != range.rows().end(); image_x++)
 		{
-			int64_t fractal_x = fractal_width * m_normalizedPosition.x - m_pixelBufferWidth / 2 + image_x;
-			int64_t fractal_y = fractal_heigth * m_normalizedPosition.y - m_pixelBufferHeigth / 2 + image_y;
+			IterationColorizer::color(getPixel(image_x, image_y), data, 0, m_resolution);
 			
-			double c_r = fractal_x / (double)zoom_x + fractal_left;
-			double c_i = fractal_y / (double)zoom_y + fractal_bottom;
-			double z_r = 0;
-			double z_i = 0;
-			double i   = 0;
+			if (m_iterationBuffer != NULL)
+				m_iterationBuffer[image_y * m_pixelBufferWidth + image_x] = m_resolution;
 			
-			do{
-				double tmp = z_r;
-				z_r = z_r * z_r - z_i * z_i + c_r;
-				z_i = 2 * tmp * z_i + c_i;
-				i++;
-			} while (z_r * z_r + z_i * z_i < 4 && i < m_resolution);
+			if (m_distanceBuffer != NULL)
+				m_distanceBuffer[image_y * m_pixelBufferWidth + image_x] = 0;
+		}
+	}
+}
+
+
+void MandelbrotRenderer::renderColumns(const std::vector<unsigned>& columns, unsigned top, unsigned bottom) const
+{
+	if (m_precision == PerturbationPrecision || m_precision == ExtendedPerturbationPrecision)
+	{
+		render<IterationColorizer, IterationColorizer::Outputs>(columns, top, bottom);
+		return;
+	}
+	
+	switch (m_coloring) {
+		case IterationColoring:	renderWith<IterationColorizer>(columns, top, bottom);	break;
+		case SmoothColoring:	renderWith<SmoothColorizer>(columns, top, bottom);		break;
+		case OrbitTrapColoring:	renderWith<OrbitTrapColorizer>(columns, top, bottom);	break;
+		case LightingColoring:	renderWith<LightingColorizer>(columns, top, bottom);	break;
+		case DistanceColoring:	renderWith<DistanceColorizer>(columns, top, bottom);	break;
+	}
+}
+
+
+// The distance estimates need the final z and dz/dc whatever the colorizer
+template <class Colorizer>
+void MandelbrotRenderer::renderWith(const std::vector<unsigned>& columns, unsigned top, unsigned bottom) const
+{
+	typedef typename Colorizer::Outputs Outputs;
+	
+	if (m_distanceBuffer != NULL)
+		render<Colorizer, PixelOutputs<true, true, Outputs::minimumNorm> >(columns, top, bottom);
+	else
+		render<Colorizer, Outputs>(columns, top, bottom);
+}
+
+
+template <class Colorizer, class Outputs>
+void MandelbrotRenderer::render(const std::vector<unsigned>& columns, unsigned top, unsigned bottom) const
+{
+	// Without rotation, the real part only depends on the column, so compute
+	// it once for all the rows and let the kernel iterate the columns row by
+	// row, whether they are contiguous or not. In a rotated view, every pixel
+	// has its own real and imaginary parts and makes a run of its own.
+	bool rotated = m_viewport.isRotated();
+	unsigned runLength = rotated ? 1 : columns.size();
+	Run& run = getRun(runLength);
+	sf::Vector2u origin = getOrigin();
+	
+	for (unsigned image_y = top; image_y != bottom; image_y++)
+	{
+		for (unsigned start = 0; start != columns.size(); start += runLength)
+		{
+			if (rotated || image_y == top)
+			{
+				for (unsigned column = 0; column < runLength; column++)
+					setRunPoint(run, column, m_viewport.getOffset(origin, columns[start + column], image_y));
+			}
+			
+			iterateRun<Outputs>(run, m_viewport.getOffset(origin, columns[start], image_y), runLength, m_resolution);
 			
-			if (i == m_resolution)
+			for (unsigned column = 0; column < runLength; column++)
 			{
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 0] = 0;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 1] = 54;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 2] = 76;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 3] = 255;
+				unsigned image_x = columns[start + column];
+				Colorizer::color(getPixel(image_x, image_y), run.data, column, m_resolution);
+				
+				if (m_iterationBuffer != NULL)
+					m_iterationBuffer[image_y * m_pixelBufferWidth + image_x] = run.iterations[column];
+				
+				if (Outputs::finalZ && Outputs::derivative && m_distanceBuffer != NULL)
+				{
+					float distance = 0;
+					
+					if (run.iterations[column] != m_resolution)
+						distance = estimateDistance(run.data, column) / run.data.pixelSpacing;
+					
+					m_distanceBuffer[image_y * m_pixelBufferWidth + image_x] = distance;
+				}
 			}
-			else
+		}
+	}
+}
+
+
+void MandelbrotRenderer::renderSamples(unsigned image_y, const std::vector<unsigned>& columns, unsigned samples) const
+{
+	if (columns.empty())
+		return;
+	
+	if (m_precision == PerturbationPrecision || m_precision == ExtendedPerturbationPrecision)
+	{
+		sample<IterationColorizer>(image_y, columns, samples);
+		return;
+	}
+	
+	switch (m_coloring) {
+		case IterationColoring:	sample<IterationColorizer>(image_y, columns, samples);	break;
+		case SmoothColoring:	sample<SmoothColorizer>(image_y, columns, samples);		break;
+		case OrbitTrapColoring:	sample<OrbitTrapColorizer>(image_y, columns, samples);	break;
+		case LightingColoring:	sample<LightingColorizer>(image_y, columns, samples);	break;
+		case DistanceColoring:	sample<DistanceColorizer>(image_y, columns, samples);	break;
+	}
+}
+
+
+// The samples of a pixel are the centers of the cells of a grid dividing it,
+// and a row of cells across all the pixels makes a run. The samples get a
+// larger iteration budget, and those escaping past the resolution get the
+// color of the last iteration instead of the inside one. The perturbation
+// references are only computed up to the resolution.
+template <class Colorizer>
+void MandelbrotRenderer::sample(unsigned image_y, const std::vector<unsigned>& columns, unsigned samples) const
+{
+	int budget = hasDistanceEstimates() ? samplingBudget * m_resolution : m_resolution;
+	bool rotated = m_viewport.isRotated();
+	unsigned count = columns.size() * samples;
+	unsigned runLength = rotated ? 1 : count;
+	Run& run = getRun(runLength);
+	sf::Vector2u origin = getOrigin();
+	std::vector<unsigned> sums(columns.size() * 3, 0);
+	
+	for (unsigned row = 0; row < samples; row++)
+	{
+		double sample_y = image_y + (row + 0.5) / samples - 0.5;
+		
+		for (unsigned start = 0; start != count; start += runLength)
+		{
+			if (rotated || row == 0)
 			{
-				int val = i * 255 / m_resolution;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 0] = val;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 1] = 0;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 2] = 0;
-				m_pixelBuffer[(image_y * m_pixelBufferWidth + image_x) * 4 + 3] = 255;
+				for (unsigned column = 0; column < runLength; column++)
+				{
+					unsigned index = start + column;
+					double sample_x = columns[index / samples] + (index % samples + 0.5) / samples - 0.5;
+					setRunPoint(run, column, m_viewport.getOffset(origin, Vector2lf(sample_x, sample_y)));
+				}
+			}
+			
+			// In a rotated view, the imaginary part also depends on x, and the
+			// single sample of the run gives it
+			double run_x = columns[start / samples];
+			
+			if (rotated)
+				run_x += (start % samples + 0.5) / samples - 0.5;
+			
+			iterateRun<typename Colorizer::Outputs>(run, m_viewport.getOffset(origin, Vector2lf(run_x, sample_y)),
+													runLength, budget);
+			
+			for (unsigned column = 0; column < runLength; column++)
+			{
+				unsigned char color[4];
+				unsigned pixel = (start + column) / samples;
+				
+				if (run.iterations[column] == budget)
+					run.iterations[column] = m_resolution;
+				else if (run.iterations[column] >= m_resolution)
+					run.iterations[column] = m_resolution - 1;
+				
+				Colorizer::color(color, run.data, column, m_resolution);
+				
+				sums[pixel * 3] += color[0];
+				sums[pixel * 3 + 1] += color[1];
+				sums[pixel * 3 + 2] += color[2];
 			}
 		}
 	}
+	
+	for (unsigned pixel = 0; pixel < columns.size(); pixel++)
+	{
+		unsigned char *color = getPixel(columns[pixel], image_y);
+		
+		for (unsigned channel = 0; channel < 3; channel++)
+			color[channel] = (sums[pixel * 3 + channel] + samples * samples / 2) / (samples * samples);
+		
+		color[3] = 255;
+	}
+}
+
+
+void MandelbrotRenderer::Run::resize(unsigned length)
+{
+	c_r.resize(length);
+	c_r_lo.resize(length);
+	c_r_float.resize(length);
+	c_r_quad.resize(length);
+	c_r_fe.resize(length);
+	iterations.resize(length);
+	z_r.resize(length);
+	z_i.resize(length);
+	dz_r.resize(length);
+	dz_i.resize(length);
+	minimumNorm.resize(length);
+	
+	data.iterations = &iterations[0];
+	data.z_r = &z_r[0];
+	data.z_i = &z_i[0];
+	data.dz_r = &dz_r[0];
+	data.dz_i = &dz_i[0];
+	data.minimumNorm = &minimumNorm[0];
+}
+
+
+// The buffers of a thread only ever grow, so that the calls for single rows
+// or pixels stop allocating once the longest run has been seen
+MandelbrotRenderer::Run& MandelbrotRenderer::getRun(unsigned length) const
+{
+	Run& run = m_runs->local();
+	
+	if (run.iterations.size() < length)
+		run.resize(length);
+	
+	run.data.pixelSpacing = m_viewport.getPixelSpacing().toDouble();
+	return run;
+}
+
+
+// The real part of a point, in the form the kernel of the precision takes
+void MandelbrotRenderer::setRunPoint(Run& run, unsigned index, const Vector2fe& offset) const
+{
+	if (m_precision == ExtendedPerturbationPrecision)
+	{
+		run.c_r_fe[index] = offset.x;
+	}
+	else if (m_precision == PerturbationPrecision)
+	{
+		run.c_r[index] = offset.x.toDouble();
+	}
+	else if (m_precision == QuadDoublePrecision)
+	{
+		run.c_r_quad[index] = m_centerQD.x + offset.x.toDouble();
+	}
+	else if (m_precision == DoubleDoublePrecision)
+	{
+		DoubleDouble c = m_centerDD.x + offset.x.toDouble();
+		run.c_r[index] = c.hi;
+		run.c_r_lo[index] = c.lo;
+	}
+	else
+	{
+		run.c_r[index] = m_center.x + offset.x.toDouble();
+		run.c_r_float[index] = run.c_r[index];
+	}
+}
+
+
+// The registered kernels only give iteration counts, and the colorizers that
+// need more get kernels computing exactly what they need instead. The
+// imaginary part is taken from the offset of any point of the run, and the
+// iteration budget is 'resolution'.
+template <class Outputs>
+void MandelbrotRenderer::iterateRun(Run& run, const Vector2fe& offset, unsigned count, int resolution) const
+{
+	typedef EscapeTimeOutputKernels<Outputs> OutputKernels;
+	double tolerance = getPeriodicityTolerance();
+	
+	switch (m_precision) {
+		case SinglePrecision:
+			if (Outputs::extras)
+				OutputKernels::floatKernel(&run.c_r_float[0], m_center.y + offset.y.toDouble(),
+										   count, resolution, tolerance, run.data);
+			else
+				m_kernels->floatKernel(&run.c_r_float[0], m_center.y + offset.y.toDouble(),
+									   count, resolution, tolerance, &run.iterations[0]);
+			break;
+			
+		case DoublePrecision:
+			if (Outputs::extras)
+				OutputKernels::kernel(&run.c_r[0], m_center.y + offset.y.toDouble(),
+									  count, resolution, tolerance, run.data);
+			else
+				m_kernels->kernel(&run.c_r[0], m_center.y + offset.y.toDouble(),
+								  count, resolution, tolerance, &run.iterations[0]);
+			break;
+			
+		case DoubleDoublePrecision:
+			if (Outputs::extras)
+				OutputKernels::doubleDoubleKernel(&run.c_r[0], &run.c_r_lo[0], m_centerDD.y + offset.y.toDouble(),
+												  count, resolution, tolerance, run.data);
+			else
+				m_kernels->doubleDoubleKernel(&run.c_r[0], &run.c_r_lo[0], m_centerDD.y + offset.y.toDouble(),
+											  count, resolution, tolerance, &run.iterations[0]);
+			break;
+			
+		case QuadDoublePrecision:
+			if (Outputs::extras)
+				OutputKernels::quadDoubleKernel(&run.c_r_quad[0], m_centerQD.y + offset.y.toDouble(),
+												count, resolution, tolerance, run.data);
+			else
+				escapeTimeScalarQD(&run.c_r_quad[0], m_centerQD.y + offset.y.toDouble(),
+								   count, resolution, tolerance, &run.iterations[0]);
+			break;
+			
+		case PerturbationPrecision:
+			escapeTimePerturbation(*m_reference, &run.c_r[0], offset.y.toDouble(),
+								   count, resolution, tolerance, &run.iterations[0]);
+			break;
+			
+		case ExtendedPerturbationPrecision:
+			escapeTimePerturbationFE(*m_reference, &run.c_r_fe[0], offset.y,
+									 count, resolution, tolerance, &run.iterations[0]);
+			break;
+	}
+}
+
+
+const Viewport& MandelbrotRenderer::getViewport(void) const
+{
+	return m_viewport;
+}
+
+
+sf::Vector2u MandelbrotRenderer::getReferencePoint(void) const
+{
+	return m_viewport.getCenterPixel();
+}
+
+
+// 0 when periodicity checking is off, which the kernels take as such
+double MandelbrotRenderer::getPeriodicityTolerance(void) const
+{
+	if (!m_periodicityChecking)
+		return 0;
+	
+	double tolerance = (m_viewport.getPixelSpacing() * periodicityTolerance).toDouble();
+	
+	// Below the range of doubles, only exact repeats are caught
+	if (m_precision == ExtendedPerturbationPrecision)
+		tolerance = std::max(tolerance, DBL_MIN);
+	
+	return tolerance;
+}
+
+
+int MandelbrotRenderer::getResolution(void) const
+{
+	return m_resolution;
+}
+
+
+// The kernels are given every coordinate as an offset from this pixel, added
+// to its coordinates in the precision of the kernel unless perturbation takes
+// the offsets themselves
+sf::Vector2u MandelbrotRenderer::getOrigin(void) const
+{
+	if (m_precision == PerturbationPrecision || m_precision == ExtendedPerturbationPrecision)
+		return m_reference->getPoint();
+	
+	return m_viewport.getCenterPixel();
+}
+
+
+unsigned char *MandelbrotRenderer::getPixel(unsigned image_x, unsigned image_y) const
+{
+	return m_pixelBuffer + (image_y * m_pixelBufferWidth + image_x) * 4;
 }
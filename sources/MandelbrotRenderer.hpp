@@ -28,25 +28,132 @@
 #ifndef MANDELBROT_RENDERER_HPP
 #define MANDELBROT_RENDERER_HPP
 
-#include <SFML/System/Vector2.hpp>
 #include <tbb/blocked_range2d.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <memory>
+#include <vector>
+#include "Viewport.hpp"
+#include "KernelRegistry.hpp"
+#include "PerturbationReference.hpp"
 
-typedef sf::Vector2<double>        Vector2lf;
+enum Precision {
+	SinglePrecision,
+	DoublePrecision,
+	DoubleDoublePrecision,
+	QuadDoublePrecision,
+	PerturbationPrecision,
+	ExtendedPerturbationPrecision
+};
+
+enum Coloring {
+	IterationColoring,
+	SmoothColoring,
+	OrbitTrapColoring,
+	LightingColoring,
+	DistanceColoring
+};
 
 class MandelbrotRenderer {
 	unsigned char *m_pixelBuffer;
 	unsigned m_pixelBufferWidth;
 	unsigned m_pixelBufferHeigth;
 	
-	double m_zoom;
+	Viewport m_viewport;
+	Vector2lf m_center;
+	Vector2dd m_centerDD;
+	Vector2qd m_centerQD;
 	int m_resolution;
-	Vector2lf m_normalizedPosition;
+	const KernelRegistry::Entry *m_kernels;
+	Precision m_precision;
+	Coloring m_coloring;
+	bool m_periodicityChecking;
+	bool m_interiorProof;
+	const PerturbationReference *m_reference;
+	int *m_iterationBuffer;
+	float *m_distanceBuffer;
+	
+	// The buffers of the kernel runs, which each thread keeps for the whole
+	// rendering, shared by the copies tbb makes of the renderer
+	struct Run;
+	std::shared_ptr<tbb::enumerable_thread_specific<Run> > m_runs;
 	
 public:
-	MandelbrotRenderer(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
-					   double zoom, int resolution, const Vector2lf& normalizedPosition);
+	MandelbrotRenderer(unsigned char *pixelBuffer, const Viewport& viewport, int resolution,
+					   const KernelRegistry::Entry& kernels);
+	
+	void setPrecision(Precision precision);
+	Precision getPrecision(void) const;
+	
+	// The iteration coloring is used in the perturbation precisions, whose
+	// kernels give nothing else
+	void setColoring(Coloring coloring);
+	bool isColoredByIterations(void) const;
+	
+	// Whether conjugate points get the same color
+	bool isConjugateSymmetric(void) const;
+	
+	// Stop iterating the pixels whose orbit has settled on a cycle, which
+	// are inside the set. Off by default: the tolerance makes it unlikely,
+	// but not impossible, that an escaping pixel is taken for an interior one.
+	void setPeriodicityChecking(bool enabled);
+	
+	// Try to prove that each tile given lies inside the set before iterating
+	// its pixels, and paint it as such if so. Off by default, as it makes the
+	// rendering time depend on more than the kernels. Never tried in single
+	// precision, whose coordinates are rounded far more than the proof allows.
+	void setInteriorProof(bool enabled);
+	
+	// Perturbation iterates all the pixels around the orbit of a single
+	// reference pixel
+	void setPerturbation(const PerturbationReference& reference);
+	
+	// Also store the iteration count of each pixel, row by row, for the
+	// renderings that guess pixels from their neighbours
+	void setIterationBuffer(int *iterations);
+	
+	// Also store the distance estimate of each pixel, row by row, in pixel
+	// spacings, 0 inside the set. Perturbation gives no estimates.
+	void setDistanceBuffer(float *distances);
+	bool hasDistanceEstimates(void) const;
 	
 	void operator()(const tbb::blocked_range2d<unsigned, unsigned>& range) const;
+	
+	// Compute the given pixels of a row only, in a single run of the kernel
+	// unless the view is rotated
+	void renderPixels(unsigned image_y, const std::vector<unsigned>& columns) const;
+	
+	// Color the given pixels of a row with the average of a grid of
+	// 'samples' by 'samples' points spread over each of them, iterated with a
+	// larger budget outside the perturbation precisions
+	void renderSamples(unsigned image_y, const std::vector<unsigned>& columns, unsigned samples) const;
+	
+	const Viewport& getViewport(void) const;
+	sf::Vector2u getReferencePoint(void) const;
+	double getPeriodicityTolerance(void) const;
+	int getResolution(void) const;
+	
+private:
+	bool isProvenInterior(const tbb::blocked_range2d<unsigned, unsigned>& range) const;
+	void fillInterior(const tbb::blocked_range2d<unsigned, unsigned>& range) const;
+	void renderColumns(const std::vector<unsigned>& columns, unsigned top, unsigned bottom) const;
+	
+	template <class Colorizer>
+	void renderWith(const std::vector<unsigned>& columns, unsigned top, unsigned bottom) const;
+	
+	template <class Colorizer, class Outputs>
+	void render(const std::vector<unsigned>& columns, unsigned top, unsigned bottom) const;
+	
+	template <class Colorizer>
+	void sample(unsigned image_y, const std::vector<unsigned>& columns, unsigned samples) const;
+	
+	Run& getRun(unsigned length) const;
+	void setRunPoint(Run& run, unsigned index, const Vector2fe& offset) const;
+	
+	template <class Outputs>
+	void iterateRun(Run& run, const Vector2fe& offset, unsigned count, int resolution) const;
+	
+	sf::Vector2u getOrigin(void) const;
+	unsigned char *getPixel(unsigned image_x, unsigned image_y) const;
 };
 
 #endif
@@ -0,0 +1,167 @@
+
+/*
+ *  MarianiSilver.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "MarianiSilver.hpp"
+#include <tbb/parallel_invoke.h>
+#include <cstring>
+
+namespace {
+	// Rectangles whose inside is at most this wide or high are computed
+	const unsigned minimumSize = 16;
+	
+	class Subdivision {
+	public:
+		Subdivision(const MarianiSilver& owner, unsigned left, unsigned top, unsigned right, unsigned bottom) :
+		m_owner(owner), m_left(left), m_top(top), m_right(right), m_bottom(bottom)
+		{
+		}
+		
+		void operator()(void) const
+		{
+			m_owner.subdivide(m_left, m_top, m_right, m_bottom);
+		}
+		
+	private:
+		const MarianiSilver& m_owner;
+		unsigned m_left;
+		unsigned m_top;
+		unsigned m_right;
+		unsigned m_bottom;
+	};
+}
+
+MarianiSilver::MarianiSilver(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+							 unsigned top, unsigned bottom) :
+m_renderer(renderer),
+m_pixelBuffer(pixelBuffer),
+m_iterations(iterations),
+m_width(renderer.getViewport().getWidth()),
+m_top(top),
+m_bottom(bottom)
+{
+}
+
+
+void MarianiSilver::render(void) const
+{
+	unsigned right = m_width - 1;
+	unsigned top = m_top;
+	unsigned bottom = m_bottom - 1;
+	
+	if (right < 2 || bottom - top < 2)
+	{
+		compute(0, top, right, bottom);
+		return;
+	}
+	
+	compute(0, top, right, top);
+	compute(0, bottom, right, bottom);
+	compute(0, top + 1, 0, bottom - 1);
+	compute(right, top + 1, right, bottom - 1);
+	
+	subdivide(0, top, right, bottom);
+}
+
+
+void MarianiSilver::subdivide(unsigned left, unsigned top, unsigned right, unsigned bottom) const
+{
+	if (right - left <= minimumSize + 1 || bottom - top <= minimumSize + 1)
+	{
+		compute(left + 1, top + 1, right - 1, bottom - 1);
+		return;
+	}
+	
+	if (isUniform(left, top, right, bottom))
+	{
+		fill(left, top, right, bottom);
+		return;
+	}
+	
+	if (right - left >= bottom - top)
+	{
+		unsigned middle = (left + right) / 2;
+		compute(middle, top + 1, middle, bottom - 1);
+		tbb::parallel_invoke(Subdivision(*this, left, top, middle, bottom),
+							 Subdivision(*this, middle, top, right, bottom));
+	}
+	else
+	{
+		unsigned middle = (top + bottom) / 2;
+		compute(left + 1, middle, right - 1, middle);
+		tbb::parallel_invoke(Subdivision(*this, left, top, right, middle),
+							 Subdivision(*this, left, middle, right, bottom));
+	}
+}
+
+
+void MarianiSilver::compute(unsigned left, unsigned top, unsigned right, unsigned bottom) const
+{
+	if (left <= right && top <= bottom)
+		m_renderer(tbb::blocked_range2d<unsigned, unsigned>(left, right + 1, top, bottom + 1));
+}
+
+
+// Pixels of the same count get the same color, except with the colorings
+// computed from more than the count, where only the inside of the set can
+// be filled
+bool MarianiSilver::isUniform(unsigned left, unsigned top, unsigned right, unsigned bottom) const
+{
+	int count = m_iterations[top * m_width + left];
+	
+	if (!m_renderer.isColoredByIterations() && count != m_renderer.getResolution())
+		return false;
+	
+	for (unsigned x = left; x <= right; x++)
+	{
+		if (m_iterations[top * m_width + x] != count || m_iterations[bottom * m_width + x] != count)
+			return false;
+	}
+	
+	for (unsigned y = top + 1; y < bottom; y++)
+	{
+		if (m_iterations[y * m_width + left] != count || m_iterations[y * m_width + right] != count)
+			return false;
+	}
+	
+	return true;
+}
+
+
+void MarianiSilver::fill(unsigned left, unsigned top, unsigned right, unsigned bottom) const
+{
+	int count = m_iterations[top * m_width + left];
+	const unsigned char *color = m_pixelBuffer + (top * m_width + left) * 4;
+	
+	for (unsigned y = top + 1; y < bottom; y++)
+	{
+		for (unsigned x = left + 1; x < right; x++)
+		{
+			m_iterations[y * m_width + x] = count;
+			std::memcpy(m_pixelBuffer + (y * m_width + x) * 4, color, 4);
+		}
+	}
+}
@@ -0,0 +1,67 @@
+
+/*
+ *  MarianiSilver.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *  
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *  
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *  
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *  
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef MARIANI_SILVER_HPP
+#define MARIANI_SILVER_HPP
+
+#include "MandelbrotRenderer.hpp"
+
+// Mariani-Silver subdivision. The Mandelbrot set is connected, and so are
+// the areas of a given iteration count, so that a rectangle whose border
+// pixels all have the same count is filled with it without iterating its
+// inside. Otherwise the rectangle is split in two along its longer side by
+// computing the line between the halves, which are then subdivided in
+// parallel. Rectangles too small to be worth splitting are computed.
+//
+// A filament thinner than a pixel can still cross a rectangle without
+// touching any of its border pixels, and will then be missing.
+class MarianiSilver {
+public:
+	// Renders the rows from 'top' to 'bottom', excluded, as a whole image. The
+	// renderer must have been given 'iterations' as its iteration buffer.
+	MarianiSilver(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+				  unsigned top, unsigned bottom);
+	
+	void render(void) const;
+	
+	// The border of the rectangle, bounds included, must have been computed
+	void subdivide(unsigned left, unsigned top, unsigned right, unsigned bottom) const;
+	
+private:
+	const MandelbrotRenderer& m_renderer;
+	unsigned char *m_pixelBuffer;
+	int *m_iterations;
+	unsigned m_width;
+	unsigned m_top;
+	unsigned m_bottom;
+	
+	void compute(unsigned left, unsigned top, unsigned right, unsigned bottom) const;
+	bool isUniform(unsigned left, unsigned top, unsigned right, unsigned bottom) const;
+	void fill(unsigned left, unsigned top, unsigned right, unsigned bottom) const;
+};
+
+#endif
@@ -0,0 +1,103 @@
+
+/*
+ *  PerturbationReference.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "PerturbationReference.hpp"
+#include "MandelbrotRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+PerturbationReference::PerturbationReference(void) :
+m_point(),
+m_orbit(),
+m_series(),
+m_bilinear()
+{
+}
+
+
+void PerturbationReference::compute(const MandelbrotRenderer& renderer, sf::Vector2u point,
+									sf::Vector2u areaMin, sf::Vector2u areaMax)
+{
+	m_point = point;
+	
+	// Enough bits to tell pixels apart, plus a double worth of margin
+	const Viewport& viewport = renderer.getViewport();
+	FloatExp spacing = viewport.getPixelSpacing();
+	Vector2bf c = viewport.getCoordinates(point.x, point.y);
+	m_orbit.compute(c.x, c.y, renderer.getResolution(), (FloatExp(1.0) / spacing).exponent + 64);
+	
+	// The series is checked against the corners, as the furthest pixels
+	// from the reference point. It is left empty when the offsets do not
+	// fit in doubles.
+	std::vector<Vector2fe> corners;
+	corners.push_back(viewport.getOffset(point, areaMin.x, areaMin.y));
+	corners.push_back(viewport.getOffset(point, areaMax.x, areaMin.y));
+	corners.push_back(viewport.getOffset(point, areaMin.x, areaMax.y));
+	corners.push_back(viewport.getOffset(point, areaMax.x, areaMax.y));
+	
+	std::vector<Vector2lf> probes;
+	
+	if (renderer.getPrecision() == PerturbationPrecision)
+	{
+		for (unsigned i = 0; i < corners.size(); i++)
+			probes.push_back(Vector2lf(corners[i].x.toDouble(), corners[i].y.toDouble()));
+	}
+	
+	m_series.compute(m_orbit, probes, spacing.toDouble(), renderer.getResolution());
+	
+	FloatExp maxOffset;
+	
+	for (unsigned i = 0; i < corners.size(); i++)
+		maxOffset = std::max(maxOffset, hypot(corners[i].x, corners[i].y));
+	
+	m_bilinear.compute(m_orbit, maxOffset, renderer.getResolution());
+}
+
+
+sf::Vector2u PerturbationReference::getPoint(void) const
+{
+	return m_point;
+}
+
+
+const ReferenceOrbit& PerturbationReference::getOrbit(void) const
+{
+	return m_orbit;
+}
+
+
+const SeriesApproximation& PerturbationReference::getSeries(void) const
+{
+	return m_series;
+}
+
+
+const BilinearApproximation& PerturbationReference::getBilinear(void) const
+{
+	return m_bilinear;
+}
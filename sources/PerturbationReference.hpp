@@ -0,0 +1,59 @@
+
+/*
+ *  PerturbationReference.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef PERTURBATION_REFERENCE_HPP
+#define PERTURBATION_REFERENCE_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include "ReferenceOrbit.hpp"
+#include "SeriesApproximation.hpp"
+#include "BilinearApproximation.hpp"
+
+class MandelbrotRenderer;
+
+// Everything perturbation needs to render the pixels of a rectangular area
+// of the view around one reference pixel
+class PerturbationReference {
+public:
+	PerturbationReference(void);
+	
+	void compute(const MandelbrotRenderer& renderer, sf::Vector2u point,
+				 sf::Vector2u areaMin, sf::Vector2u areaMax);
+	
+	sf::Vector2u getPoint(void) const;
+	const ReferenceOrbit& getOrbit(void) const;
+	const SeriesApproximation& getSeries(void) const;
+	const BilinearApproximation& getBilinear(void) const;
+	
+private:
+	sf::Vector2u m_point;
+	ReferenceOrbit m_orbit;
+	SeriesApproximation m_series;
+	BilinearApproximation m_bilinear;
+};
+
+#endif
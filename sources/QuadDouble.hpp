@@ -0,0 +1,337 @@
+
+/*
+ *  QuadDouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef QUAD_DOUBLE_HPP
+#define QUAD_DOUBLE_HPP
+
+#include <cmath>
+#include "DoubleDouble.hpp"
+
+// Unevaluated sum of four doubles, giving about 212 bits of mantissa. The
+// algorithms are the ones of Hida, Li and Bailey's QD library. The parts
+// are kept renormalized: each one is below half an ulp of the previous one.
+class QuadDouble {
+public:
+	QuadDouble(void)
+	{
+		parts[0] = parts[1] = parts[2] = parts[3] = 0;
+	}
+	
+	QuadDouble(double value)
+	{
+		parts[0] = value;
+		parts[1] = parts[2] = parts[3] = 0;
+	}
+	
+	QuadDouble(const DoubleDouble& value)
+	{
+		parts[0] = value.hi;
+		parts[1] = value.lo;
+		parts[2] = parts[3] = 0;
+	}
+	
+	QuadDouble(double p0, double p1, double p2, double p3)
+	{
+		parts[0] = p0;
+		parts[1] = p1;
+		parts[2] = p2;
+		parts[3] = p3;
+	}
+	
+	DoubleDouble toDoubleDouble(void) const
+	{
+		return DoubleDouble(parts[0], parts[1]);
+	}
+	
+	double parts[4];
+};
+
+namespace QuadDoubleDetail {
+	// In-place error-free sums, see quickTwoSum() and twoSum()
+	inline void quickTwoSumInPlace(double& a, double& b)
+	{
+		DoubleDouble s = quickTwoSum(a, b);
+		a = s.hi;
+		b = s.lo;
+	}
+	
+	inline void twoSumInPlace(double& a, double& b)
+	{
+		DoubleDouble s = twoSum(a, b);
+		a = s.hi;
+		b = s.lo;
+	}
+	
+	// a + b + c = a' + b' + c' with a' the rounded sum
+	inline void threeSum(double& a, double& b, double& c)
+	{
+		DoubleDouble t1 = twoSum(a, b);
+		DoubleDouble t2 = twoSum(c, t1.hi);
+		DoubleDouble t3 = twoSum(t1.lo, t2.lo);
+		
+		a = t2.hi;
+		b = t3.hi;
+		c = t3.lo;
+	}
+	
+	// Same as threeSum() but the last error term is dropped
+	inline void threeSum2(double& a, double& b, double& c)
+	{
+		DoubleDouble t1 = twoSum(a, b);
+		DoubleDouble t2 = twoSum(c, t1.hi);
+		
+		a = t2.hi;
+		b = t1.lo + t2.lo;
+	}
+	
+	inline QuadDouble renormalize(double c0, double c1, double c2, double c3, double c4)
+	{
+		if (std::isinf(c0))
+			return QuadDouble(c0, c1, c2, c3);
+		
+		quickTwoSumInPlace(c3, c4);
+		quickTwoSumInPlace(c2, c3);
+		quickTwoSumInPlace(c1, c2);
+		quickTwoSumInPlace(c0, c1);
+		
+		// Accumulate the remaining terms, moving on to the next part each
+		// time a sum leaves a nonzero error
+		double s0 = c0, s1 = c1, s2 = 0, s3 = 0;
+		
+		if (s1 != 0)
+		{
+			s2 = c2;
+			quickTwoSumInPlace(s1, s2);
+			
+			if (s2 != 0)
+			{
+				s3 = c3;
+				quickTwoSumInPlace(s2, s3);
+				
+				if (s3 != 0)
+					s3 += c4;
+				else
+					s2 += c4;
+			}
+			else
+			{
+				s2 = c3;
+				quickTwoSumInPlace(s1, s2);
+				
+				if (s2 != 0)
+				{
+					s3 = c4;
+					quickTwoSumInPlace(s2, s3);
+				}
+				else
+				{
+					s2 = c4;
+					quickTwoSumInPlace(s1, s2);
+				}
+			}
+		}
+		else
+		{
+			s1 = c2;
+			quickTwoSumInPlace(s0, s1);
+			
+			if (s1 != 0)
+			{
+				s2 = c3;
+				quickTwoSumInPlace(s1, s2);
+				
+				if (s2 != 0)
+				{
+					s3 = c4;
+					quickTwoSumInPlace(s2, s3);
+				}
+				else
+				{
+					s2 = c4;
+					quickTwoSumInPlace(s1, s2);
+				}
+			}
+			else
+			{
+				s1 = c3;
+				quickTwoSumInPlace(s0, s1);
+				
+				if (s1 != 0)
+				{
+					s2 = c4;
+					quickTwoSumInPlace(s1, s2);
+				}
+				else
+				{
+					s1 = c4;
+					quickTwoSumInPlace(s0, s1);
+				}
+			}
+		}
+		
+		return QuadDouble(s0, s1, s2, s3);
+	}
+}
+
+inline QuadDouble operator-(const QuadDouble& a)
+{
+	return QuadDouble(-a.parts[0], -a.parts[1], -a.parts[2], -a.parts[3]);
+}
+
+inline QuadDouble operator+(const QuadDouble& a, const QuadDouble& b)
+{
+	using namespace QuadDoubleDetail;
+	
+	double s0 = a.parts[0], t0 = b.parts[0];
+	double s1 = a.parts[1], t1 = b.parts[1];
+	double s2 = a.parts[2], t2 = b.parts[2];
+	double s3 = a.parts[3], t3 = b.parts[3];
+	
+	twoSumInPlace(s0, t0);
+	twoSumInPlace(s1, t1);
+	twoSumInPlace(s2, t2);
+	twoSumInPlace(s3, t3);
+	
+	twoSumInPlace(s1, t0);
+	threeSum(s2, t0, t1);
+	threeSum2(s3, t0, t2);
+	t0 = t0 + t1 + t3;
+	
+	return renormalize(s0, s1, s2, s3, t0);
+}
+
+inline QuadDouble operator-(const QuadDouble& a, const QuadDouble& b)
+{
+	return a + -b;
+}
+
+inline QuadDouble operator*(const QuadDouble& a, double b)
+{
+	using namespace QuadDoubleDetail;
+	
+	DoubleDouble p0 = twoProd(a.parts[0], b);
+	DoubleDouble p1 = twoProd(a.parts[1], b);
+	DoubleDouble p2 = twoProd(a.parts[2], b);
+	double p3 = a.parts[3] * b;
+	
+	double s1 = p0.lo;
+	double s2 = p1.hi;
+	twoSumInPlace(s1, s2);
+	
+	double q1 = p1.lo;
+	double r2 = p2.hi;
+	threeSum(s2, q1, r2);
+	
+	double q2 = p2.lo;
+	threeSum2(q1, q2, p3);
+	
+	return renormalize(p0.hi, s1, s2, q1, q2 + r2);
+}
+
+inline QuadDouble operator*(const QuadDouble& a, const QuadDouble& b)
+{
+	using namespace QuadDoubleDetail;
+	
+	DoubleDouble t0 = twoProd(a.parts[0], b.parts[0]);
+	DoubleDouble t1 = twoProd(a.parts[0], b.parts[1]);
+	DoubleDouble t2 = twoProd(a.parts[1], b.parts[0]);
+	DoubleDouble t3 = twoProd(a.parts[0], b.parts[2]);
+	DoubleDouble t4 = twoProd(a.parts[1], b.parts[1]);
+	DoubleDouble t5 = twoProd(a.parts[2], b.parts[0]);
+	
+	double p0 = t0.hi, q0 = t0.lo;
+	double p1 = t1.hi, q1 = t1.lo;
+	double p2 = t2.hi, q2 = t2.lo;
+	double p3 = t3.hi, q3 = t3.lo;
+	double p4 = t4.hi, q4 = t4.lo;
+	double p5 = t5.hi, q5 = t5.lo;
+	
+	threeSum(p1, p2, q0);
+	
+	// Six-three sum of p2, q1, q2, p3, p4, p5
+	threeSum(p2, q1, q2);
+	threeSum(p3, p4, p5);
+	
+	double s0 = p2, e0 = p3;
+	double s1 = q1, e1 = p4;
+	twoSumInPlace(s0, e0);
+	twoSumInPlace(s1, e1);
+	double s2 = q2 + p5;
+	twoSumInPlace(s1, e0);
+	s2 += e0 + e1;
+	
+	// Terms of the order of eps^3
+	s1 += a.parts[0] * b.parts[3] + a.parts[1] * b.parts[2] + a.parts[2] * b.parts[1] +
+		a.parts[3] * b.parts[0] + q0 + q3 + q4 + q5;
+	
+	return renormalize(p0, p1, s0, s1, s2);
+}
+
+inline QuadDouble sqr(const QuadDouble& a)
+{
+	return a * a;
+}
+
+inline QuadDouble operator/(const QuadDouble& a, double b)
+{
+	double q0 = a.parts[0] / b;
+	QuadDouble r = a - QuadDouble(twoProd(q0, b));
+	double q1 = r.parts[0] / b;
+	r = r - QuadDouble(twoProd(q1, b));
+	double q2 = r.parts[0] / b;
+	r = r - QuadDouble(twoProd(q2, b));
+	double q3 = r.parts[0] / b;
+	
+	return QuadDoubleDetail::renormalize(q0, q1, q2, q3, 0);
+}
+
+inline QuadDouble& operator+=(QuadDouble& a, const QuadDouble& b)
+{
+	return a = a + b;
+}
+
+inline QuadDouble& operator-=(QuadDouble& a, const QuadDouble& b)
+{
+	return a = a - b;
+}
+
+inline QuadDouble floor(const QuadDouble& a)
+{
+	double x[4] = {std::floor(a.parts[0]), 0, 0, 0};
+	
+	for (unsigned i = 1; i < 4 && x[i - 1] == a.parts[i - 1]; i++)
+		x[i] = std::floor(a.parts[i]);
+	
+	return QuadDoubleDetail::renormalize(x[0], x[1], x[2], x[3], 0);
+}
+
+inline QuadDouble trunc(const QuadDouble& a)
+{
+	return (a.parts[0] < 0) ? -floor(-a) : floor(a);
+}
+
+#endif
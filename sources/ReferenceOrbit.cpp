@@ -0,0 +1,95 @@
+
+/*
+ *  ReferenceOrbit.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "ReferenceOrbit.hpp"
+
+ReferenceOrbit::ReferenceOrbit(void) :
+m_realParts(),
+m_imaginaryParts()
+{
+}
+
+
+void ReferenceOrbit::compute(const BigFloat<64>& c_r, const BigFloat<64>& c_i, int maxIterations, unsigned bits)
+{
+	// The cost grows with the square of the precision, so use the smallest
+	// one that is enough
+	if (bits <= 32 * 8)
+		iterate<8>(c_r, c_i, maxIterations);
+	else if (bits <= 32 * 16)
+		iterate<16>(c_r, c_i, maxIterations);
+	else if (bits <= 32 * 32)
+		iterate<32>(c_r, c_i, maxIterations);
+	else
+		iterate<64>(c_r, c_i, maxIterations);
+}
+
+
+unsigned ReferenceOrbit::getLength(void) const
+{
+	return m_realParts.size();
+}
+
+
+const double *ReferenceOrbit::getRealParts(void) const
+{
+	return &m_realParts[0];
+}
+
+
+const double *ReferenceOrbit::getImaginaryParts(void) const
+{
+	return &m_imaginaryParts[0];
+}
+
+
+template <unsigned Limbs>
+void ReferenceOrbit::iterate(const BigFloat<64>& c_r, const BigFloat<64>& c_i, int maxIterations)
+{
+	const BigFloat<Limbs> r(c_r);
+	const BigFloat<Limbs> i(c_i);
+	BigFloat<Limbs> z_r;
+	BigFloat<Limbs> z_i;
+	double z_r_double = 0;
+	double z_i_double = 0;
+	
+	m_realParts.assign(1, 0);
+	m_imaginaryParts.assign(1, 0);
+	
+	// Same trick as the quad-double kernel: two multiplications per iteration
+	for (int n = 0; n < maxIterations && z_r_double * z_r_double + z_i_double * z_i_double < 4; n++)
+	{
+		BigFloat<Limbs> z_ri = z_r * z_i;
+		z_r = (z_r + z_i) * (z_r - z_i) + r;
+		z_i = ldexp(z_ri, 1) + i;
+		
+		z_r_double = z_r.toDouble();
+		z_i_double = z_i.toDouble();
+		m_realParts.push_back(z_r_double);
+		m_imaginaryParts.push_back(z_i_double);
+	}
+}
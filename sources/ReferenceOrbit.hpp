@@ -0,0 +1,57 @@
+
+/*
+ *  ReferenceOrbit.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef REFERENCE_ORBIT_HPP
+#define REFERENCE_ORBIT_HPP
+
+#include <vector>
+#include "BigFloat.hpp"
+
+// Orbit of a single point computed with enough precision for the current
+// zoom, then rounded to doubles so that the pixels around that point can
+// be iterated as small perturbations of it
+class ReferenceOrbit {
+public:
+	ReferenceOrbit(void);
+	
+	// Computes Z_0 = 0 up to the first escaping Z_n or up to Z_maxIterations,
+	// with at least 'bits' bits of precision
+	void compute(const BigFloat<64>& c_r, const BigFloat<64>& c_i, int maxIterations, unsigned bits);
+	
+	unsigned getLength(void) const;
+	const double *getRealParts(void) const;
+	const double *getImaginaryParts(void) const;
+	
+private:
+	std::vector<double> m_realParts;
+	std::vector<double> m_imaginaryParts;
+	
+	template <unsigned Limbs>
+	void iterate(const BigFloat<64>& c_r, const BigFloat<64>& c_i, int maxIterations);
+};
+
+#endif
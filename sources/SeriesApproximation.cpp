@@ -0,0 +1,133 @@
+
+/*
+ *  SeriesApproximation.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "SeriesApproximation.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	typedef sf::Vector2<double> Complex;
+	
+	Complex multiply(const Complex& a, const Complex& b)
+	{
+		return Complex(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+	}
+	
+	// Offsets are far too small to be squared at deep zooms
+	double magnitude(const Complex& a)
+	{
+		return std::hypot(a.x, a.y);
+	}
+}
+
+SeriesApproximation::SeriesApproximation(void) :
+m_skippedIterations(0),
+m_radius(1),
+m_a(),
+m_b(),
+m_c()
+{
+}
+
+
+void SeriesApproximation::compute(const ReferenceOrbit& referenceOrbit, const std::vector<Complex>& probes,
+								  double pixelSpacing, int maxIterations)
+{
+	// Wrong by at most this fraction of the distance between two pixels
+	const double tolerance = 1e-9;
+	const double *Z_r = referenceOrbit.getRealParts();
+	const double *Z_i = referenceOrbit.getImaginaryParts();
+	int length = std::min<int>(maxIterations, referenceOrbit.getLength() - 1);
+	
+	m_skippedIterations = 0;
+	m_radius = 0;
+	m_a = m_b = m_c = Complex();
+	
+	for (unsigned p = 0; p < probes.size(); p++)
+		m_radius = std::max(m_radius, magnitude(probes[p]));
+	
+	if (m_radius == 0)
+	{
+		m_radius = 1;
+		return;
+	}
+	
+	std::vector<Complex> offsets(probes.size());
+	Complex a, b, c;
+	
+	// At least one iteration is left to the kernels
+	for (int n = 0; n + 1 < length; n++)
+	{
+		Complex Z2(2 * Z_r[n], 2 * Z_i[n]);
+		Complex next_a = multiply(Z2, a) + Complex(m_radius, 0);
+		Complex next_b = multiply(Z2, b) + multiply(a, a);
+		Complex next_c = multiply(Z2, c) + multiply(a, b) * 2.0;
+		a = next_a;
+		b = next_b;
+		c = next_c;
+		
+		// The error allowed shrinks as the pixels get further apart
+		double allowed = tolerance * pixelSpacing * (magnitude(a) / m_radius);
+		bool valid = true;
+		
+		for (unsigned p = 0; p < probes.size(); p++)
+		{
+			Complex& d = offsets[p];
+			d = multiply(Z2 + d, d) + probes[p];
+			
+			Complex u = probes[p] / m_radius;
+			Complex series = multiply(multiply(multiply(c, u) + b, u) + a, u);
+			Complex z(Z_r[n + 1] + d.x, Z_i[n + 1] + d.y);
+			
+			if (magnitude(series - d) > allowed || z.x * z.x + z.y * z.y >= 4)
+				valid = false;
+		}
+		
+		if (!valid)
+			break;
+		
+		m_skippedIterations = n + 1;
+		m_a = a;
+		m_b = b;
+		m_c = c;
+	}
+}
+
+
+int SeriesApproximation::getSkippedIterations(void) const
+{
+	return m_skippedIterations;
+}
+
+
+void SeriesApproximation::evaluate(double dc_r, double dc_i, double& d_r, double& d_i) const
+{
+	Complex u(dc_r / m_radius, dc_i / m_radius);
+	Complex d = multiply(multiply(multiply(m_c, u) + m_b, u) + m_a, u);
+	d_r = d.x;
+	d_i = d.y;
+}
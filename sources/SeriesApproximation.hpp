@@ -0,0 +1,62 @@
+
+/*
+ *  SeriesApproximation.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef SERIES_APPROXIMATION_HPP
+#define SERIES_APPROXIMATION_HPP
+
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "ReferenceOrbit.hpp"
+
+// Third order series d_n = A_n dc + B_n dc^2 + C_n dc^3 giving the offset
+// from the reference orbit after n iterations for a pixel at offset dc from
+// the reference point. As long as it holds, every pixel can start iterating
+// at iteration n instead of 0.
+class SeriesApproximation {
+public:
+	SeriesApproximation(void);
+	
+	// Finds the largest n for which the series matches the actual offsets of
+	// all the probe points (offsets from the reference point, typically the
+	// corners of the view) to a small fraction of a pixel
+	void compute(const ReferenceOrbit& referenceOrbit, const std::vector<sf::Vector2<double> >& probes,
+				 double pixelSpacing, int maxIterations);
+	
+	int getSkippedIterations(void) const;
+	void evaluate(double dc_r, double dc_i, double& d_r, double& d_i) const;
+	
+private:
+	// The coefficients are stored multiplied by the matching power of the
+	// probes radius, so that they neither overflow nor underflow
+	int m_skippedIterations;
+	double m_radius;
+	sf::Vector2<double> m_a;
+	sf::Vector2<double> m_b;
+	sf::Vector2<double> m_c;
+};
+
+#endif
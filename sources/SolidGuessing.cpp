@@ -0,0 +1,245 @@
+
+/*
+ *  SolidGuessing.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "SolidGuessing.hpp"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	// Spacing of the pixels of the first pass
+	const unsigned initialStep = 8;
+	
+	class Refinement {
+	public:
+		Refinement(SolidGuessing& owner, unsigned top, unsigned step) :
+		m_owner(owner), m_top(top), m_step(step)
+		{
+		}
+		
+		void operator()(const tbb::blocked_range<unsigned>& rows) const
+		{
+			for (unsigned row = rows.begin(); row != rows.end(); row++)
+				m_owner.refine(m_top + row * m_step, m_step);
+		}
+		
+	private:
+		SolidGuessing& m_owner;
+		unsigned m_top;
+		unsigned m_step;
+	};
+	
+	class RowComputing {
+	public:
+		RowComputing(const MandelbrotRenderer& renderer, const std::vector<unsigned>& rows,
+					 const std::vector<std::vector<unsigned> >& columns) :
+		m_renderer(renderer), m_rows(rows), m_columns(columns)
+		{
+		}
+		
+		void operator()(const tbb::blocked_range<unsigned>& range) const
+		{
+			for (unsigned i = range.begin(); i != range.end(); i++)
+				m_renderer.renderPixels(m_rows[i], m_columns[i]);
+		}
+		
+	private:
+		const MandelbrotRenderer& m_renderer;
+		const std::vector<unsigned>& m_rows;
+		const std::vector<std::vector<unsigned> >& m_columns;
+	};
+}
+
+SolidGuessing::SolidGuessing(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+							 unsigned top, unsigned bottom, bool verification) :
+m_renderer(renderer),
+m_pixelBuffer(pixelBuffer),
+m_iterations(iterations),
+m_width(renderer.getViewport().getWidth()),
+m_top(top),
+m_bottom(bottom),
+m_verification(verification),
+m_guessed(m_width * bottom, 0)
+{
+}
+
+
+void SolidGuessing::render(void)
+{
+	for (unsigned step = initialStep; step > 0; step /= 2)
+	{
+		unsigned rows = (m_bottom - m_top + step - 1) / step;
+		tbb::parallel_for(tbb::blocked_range<unsigned>(0, rows), Refinement(*this, m_top, step));
+	}
+	
+	if (m_verification)
+		verify();
+}
+
+
+// The rows of the previous passes only get the pixels halfway between
+// theirs, the other rows get all the pixels of the pass. The pixels guessed
+// or computed only read pixels of the previous passes.
+void SolidGuessing::refine(unsigned image_y, unsigned step)
+{
+	std::vector<unsigned> columns;
+	bool previousRow = step < initialStep && (image_y - m_top) % (2 * step) == 0;
+	
+	for (unsigned image_x = 0; image_x < m_width; image_x += step)
+	{
+		if (previousRow && image_x % (2 * step) == 0)
+			continue;
+		
+		if (step == initialStep || !guess(image_x, image_y, step))
+			columns.push_back(image_x);
+	}
+	
+	m_renderer.renderPixels(image_y, columns);
+}
+
+
+// The corners of the square of the previous pass around the pixel must have
+// the same count, except those out of the image. Pixels of the same count
+// get the same color, except with the colorings computed from more than the
+// count, where only the inside of the set can be guessed.
+bool SolidGuessing::guess(unsigned image_x, unsigned image_y, unsigned step)
+{
+	unsigned left = image_x - image_x % (2 * step);
+	unsigned top = image_y - (image_y - m_top) % (2 * step);
+	unsigned right = left + 2 * step < m_width ? left + 2 * step : left;
+	unsigned bottom = top + 2 * step < m_bottom ? top + 2 * step : top;
+	int count = m_iterations[top * m_width + left];
+	
+	if (!m_renderer.isColoredByIterations() && count != m_renderer.getResolution())
+		return false;
+	
+	if (m_iterations[top * m_width + right] != count || m_iterations[bottom * m_width + left] != count
+		|| m_iterations[bottom * m_width + right] != count)
+		return false;
+	
+	unsigned pixel = image_y * m_width + image_x;
+	m_iterations[pixel] = count;
+	std::memcpy(m_pixelBuffer + pixel * 4, m_pixelBuffer + (top * m_width + left) * 4, 4);
+	m_guessed[pixel] = 1;
+	
+	return true;
+}
+
+
+// A wrong guess can only be found where its count meets another one, and
+// the guesses are checked from there on
+void SolidGuessing::verify(void)
+{
+	std::vector<unsigned> pixels;
+	std::vector<unsigned> next;
+	std::vector<int> guesses;
+	
+	for (unsigned image_y = m_top; image_y < m_bottom; image_y++)
+	{
+		for (unsigned image_x = 0; image_x < m_width; image_x++)
+		{
+			unsigned pixel = image_y * m_width + image_x;
+			int count = m_iterations[pixel];
+			
+			if (m_guessed[pixel] &&
+				((image_x > 0 && m_iterations[pixel - 1] != count) ||
+				 (image_x + 1 < m_width && m_iterations[pixel + 1] != count) ||
+				 (image_y > m_top && m_iterations[pixel - m_width] != count) ||
+				 (image_y + 1 < m_bottom && m_iterations[pixel + m_width] != count)))
+			{
+				pixels.push_back(pixel);
+			}
+		}
+	}
+	
+	while (!pixels.empty())
+	{
+		guesses.clear();
+		next.clear();
+		
+		for (unsigned i = 0; i < pixels.size(); i++)
+		{
+			guesses.push_back(m_iterations[pixels[i]]);
+			m_guessed[pixels[i]] = 0;
+		}
+		
+		compute(pixels);
+		
+		for (unsigned i = 0; i < pixels.size(); i++)
+		{
+			unsigned pixel = pixels[i];
+			unsigned image_x = pixel % m_width;
+			unsigned image_y = pixel / m_width;
+			
+			if (m_iterations[pixel] == guesses[i])
+				continue;
+			
+			unsigned neighbours[4] = {
+				image_x > 0 ? pixel - 1 : pixel,
+				image_x + 1 < m_width ? pixel + 1 : pixel,
+				image_y > m_top ? pixel - m_width : pixel,
+				image_y + 1 < m_bottom ? pixel + m_width : pixel
+			};
+			
+			for (unsigned j = 0; j < 4; j++)
+			{
+				if (m_guessed[neighbours[j]])
+				{
+					m_guessed[neighbours[j]] = 0;
+					next.push_back(neighbours[j]);
+				}
+			}
+		}
+		
+		std::sort(next.begin(), next.end());
+		pixels.swap(next);
+	}
+}
+
+
+// The pixels must be sorted, and are computed in a single kernel run per row
+void SolidGuessing::compute(const std::vector<unsigned>& pixels) const
+{
+	std::vector<unsigned> rows;
+	std::vector<std::vector<unsigned> > columns;
+	
+	for (unsigned i = 0; i < pixels.size(); i++)
+	{
+		unsigned image_y = pixels[i] / m_width;
+		
+		if (rows.empty() || rows.back() != image_y)
+		{
+			rows.push_back(image_y);
+			columns.push_back(std::vector<unsigned>());
+		}
+		
+		columns.back().push_back(pixels[i] % m_width);
+	}
+	
+	tbb::parallel_for(tbb::blocked_range<unsigned>(0, rows.size()), RowComputing(m_renderer, rows, columns));
+}
@@ -0,0 +1,71 @@
+
+/*
+ *  SolidGuessing.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *  
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *  
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *  
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *  
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef SOLID_GUESSING_HPP
+#define SOLID_GUESSING_HPP
+
+#include "MandelbrotRenderer.hpp"
+#include <vector>
+
+// Solid guessing. A first pass computes every 8th pixel of every 8th row,
+// then each pass halves the spacing: the pixels it adds are guessed when
+// the four pixels of the previous pass around them have the same count, and
+// computed otherwise. The rows of a pass only depend on the previous passes
+// and are handled in parallel.
+//
+// Guessing is looser than subdivision, as a feature can pass between the
+// pixels of the first pass. The verification computes, after the last
+// pass, the guessed pixels next to a pixel of another count, then the
+// guessed neighbours of those that were wrong, until no guess is wrong.
+class SolidGuessing {
+public:
+	// Renders the rows from 'top' to 'bottom', excluded, as a whole image. The
+	// renderer must have been given 'iterations' as its iteration buffer.
+	SolidGuessing(const MandelbrotRenderer& renderer, unsigned char *pixelBuffer, int *iterations,
+				  unsigned top, unsigned bottom, bool verification);
+	
+	void render(void);
+	
+	// Compute or guess the pixels of a row that the pass of 'step' adds
+	void refine(unsigned image_y, unsigned step);
+	
+private:
+	const MandelbrotRenderer& m_renderer;
+	unsigned char *m_pixelBuffer;
+	int *m_iterations;
+	unsigned m_width;
+	unsigned m_top;
+	unsigned m_bottom;
+	bool m_verification;
+	std::vector<unsigned char> m_guessed;
+	
+	bool guess(unsigned image_x, unsigned image_y, unsigned step);
+	void verify(void);
+	void compute(const std::vector<unsigned>& pixels) const;
+};
+
+#endif
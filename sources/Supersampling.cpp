@@ -0,0 +1,114 @@
+
+/*
+ *  Supersampling.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "Supersampling.hpp"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <cfloat>
+#include <vector>
+
+namespace {
+	// Distance estimate, in pixel spacings, under which a pixel is sampled
+	// again. The estimate can be up to twice the distance, which must stay
+	// under the half diagonal of a pixel.
+	const float samplingDistance = 2;
+	
+	class RowSampling {
+	public:
+		RowSampling(const Supersampling& owner) :
+		m_owner(owner)
+		{
+		}
+		
+		void operator()(const tbb::blocked_range<unsigned>& rows) const
+		{
+			for (unsigned image_y = rows.begin(); image_y != rows.end(); image_y++)
+				m_owner.sampleRow(image_y);
+		}
+		
+	private:
+		const Supersampling& m_owner;
+	};
+}
+
+Supersampling::Supersampling(const MandelbrotRenderer& renderer, const int *iterations, const float *distances,
+							 unsigned top, unsigned bottom, unsigned samples) :
+m_renderer(renderer),
+m_iterations(iterations),
+m_distances(distances),
+m_width(renderer.getViewport().getWidth()),
+m_top(top),
+m_bottom(bottom),
+m_samples(samples)
+{
+}
+
+
+void Supersampling::render(void) const
+{
+	tbb::parallel_for(tbb::blocked_range<unsigned>(m_top, m_bottom), RowSampling(*this));
+}
+
+
+// The samples of all the pixels of a row are computed together
+void Supersampling::sampleRow(unsigned image_y) const
+{
+	std::vector<unsigned> columns;
+	
+	for (unsigned image_x = 0; image_x < m_width; image_x++)
+	{
+		if (isNearBoundary(image_x, image_y))
+			columns.push_back(image_x);
+	}
+	
+	m_renderer.renderSamples(image_y, columns, m_samples);
+}
+
+
+// The pixels of the inside, and those the rendering modes guessed, have no
+// estimate, and are only sampled next to a pixel on the other side of the
+// boundary
+bool Supersampling::isNearBoundary(unsigned image_x, unsigned image_y) const
+{
+	unsigned pixel = image_y * m_width + image_x;
+	int resolution = m_renderer.getResolution();
+	bool inside = (m_iterations[pixel] == resolution);
+	
+	if (!inside && m_distances[pixel] != FLT_MAX)
+		return m_distances[pixel] < samplingDistance;
+	
+	for (unsigned y = (image_y > m_top) ? image_y - 1 : image_y; y <= image_y + 1 && y < m_bottom; y++)
+	{
+		for (unsigned x = (image_x > 0) ? image_x - 1 : image_x; x <= image_x + 1 && x < m_width; x++)
+		{
+			if ((m_iterations[y * m_width + x] == resolution) != inside)
+				return true;
+		}
+	}
+	
+	return false;
+}
@@ -0,0 +1,61 @@
+
+/*
+ *  Supersampling.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *  
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *  
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *  
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *  
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef SUPERSAMPLING_HPP
+#define SUPERSAMPLING_HPP
+
+#include "MandelbrotRenderer.hpp"
+
+// Adaptive supersampling, after a rendering. The pixels whose distance
+// estimate puts the boundary of the set within their reach, and the pixels
+// of the inside next to escaping ones, are computed again as a grid of
+// samples spread over their area and given the average color. The pixels far
+// from the boundary, which make most of a view, keep their single sample.
+class Supersampling {
+public:
+	// Samples the rows from 'top' to 'bottom', excluded, whose iteration
+	// counts and distance estimates the renderer stored in the buffers given.
+	// The pixels without an estimate are left at FLT_MAX.
+	Supersampling(const MandelbrotRenderer& renderer, const int *iterations, const float *distances,
+				  unsigned top, unsigned bottom, unsigned samples);
+	
+	void render(void) const;
+	void sampleRow(unsigned image_y) const;
+	
+private:
+	const MandelbrotRenderer& m_renderer;
+	const int *m_iterations;
+	const float *m_distances;
+	unsigned m_width;
+	unsigned m_top;
+	unsigned m_bottom;
+	unsigned m_samples;
+	
+	bool isNearBoundary(unsigned image_x, unsigned image_y) const;
+};
+
+#endif
@@ -0,0 +1,192 @@
+
+/*
+ *  Viewport.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "Viewport.hpp"
+#include <cmath>
+
+namespace {
+	// Height of the view at zoom 1
+	const double fractal_height = 2.4;
+	
+	const double degree = 3.14159265358979323846 / 180;
+}
+
+Viewport::Viewport(unsigned width, unsigned height) :
+m_width(width),
+m_height(height),
+m_center(),
+m_zoom(),
+m_pixelSpacing(),
+m_rotation(0),
+m_cos(1),
+m_sin(0)
+{
+	setZoom(1.0);
+}
+
+
+void Viewport::setCenter(const Vector2bf& center)
+{
+	m_center = center;
+}
+
+
+void Viewport::setZoom(const FloatExp& zoom)
+{
+	m_zoom = zoom;
+	m_pixelSpacing = FloatExp(fractal_height) / (zoom * m_height);
+}
+
+
+// Kept in degrees so that a whole turn of steps brings it back to exactly 0,
+// where views are rendered without any rotation
+void Viewport::setRotation(double rotation)
+{
+	m_rotation = std::fmod(rotation, 360.0);
+	
+	if (m_rotation < 0)
+		m_rotation += 360;
+	
+	m_cos = std::cos(m_rotation * degree);
+	m_sin = std::sin(m_rotation * degree);
+}
+
+
+void Viewport::move(Vector2lf pixels)
+{
+	Vector2fe offset = toOffset(pixels);
+	
+	m_center.x += toBigFloat<64>(offset.x);
+	m_center.y += toBigFloat<64>(offset.y);
+}
+
+
+unsigned Viewport::getWidth(void) const
+{
+	return m_width;
+}
+
+
+unsigned Viewport::getHeight(void) const
+{
+	return m_height;
+}
+
+
+const Vector2bf& Viewport::getCenter(void) const
+{
+	return m_center;
+}
+
+
+FloatExp Viewport::getZoom(void) const
+{
+	return m_zoom;
+}
+
+
+double Viewport::getRotation(void) const
+{
+	return m_rotation;
+}
+
+
+bool Viewport::isRotated(void) const
+{
+	return m_rotation != 0;
+}
+
+
+const FloatExp& Viewport::getPixelSpacing(void) const
+{
+	return m_pixelSpacing;
+}
+
+
+sf::Vector2u Viewport::getCenterPixel(void) const
+{
+	return sf::Vector2u(m_width / 2, m_height / 2);
+}
+
+
+Vector2fe Viewport::getOffset(sf::Vector2u from, unsigned image_x, unsigned image_y) const
+{
+	return toOffset(Vector2lf((double)image_x - from.x, (double)image_y - from.y));
+}
+
+
+Vector2fe Viewport::getOffset(sf::Vector2u from, Vector2lf position) const
+{
+	return toOffset(Vector2lf(position.x - from.x, position.y - from.y));
+}
+
+
+// In full precision, for the reference orbit of perturbation. The zoom may be
+// past the range of doubles here.
+Vector2bf Viewport::getCoordinates(unsigned image_x, unsigned image_y) const
+{
+	Vector2fe offset = getOffset(getCenterPixel(), image_x, image_y);
+	
+	return Vector2bf(m_center.x + toBigFloat<64>(offset.x), m_center.y + toBigFloat<64>(offset.y));
+}
+
+
+// The axis is where the imaginary part is 0, at the row of the center pixel
+// minus the center's imaginary part in pixel spacings. The nearest half row is
+// found in double, and then checked exactly: the product of the spacing by a
+// number of half rows fits in the mantissa, so that it is the center's
+// imaginary part only if the axis is really on the lattice.
+bool Viewport::getMirror(unsigned& mirror) const
+{
+	if (isRotated())
+		return false;
+	
+	BigFloat<64> spacing = toBigFloat<64>(m_pixelSpacing);
+	double halfRows = std::floor(2 * (m_center.y / spacing).toDouble() + 0.5);
+	double row = 2.0 * (m_height / 2) - halfRows;
+	
+	if (row < 0 || row > 2.0 * (m_height - 1))
+		return false;
+	
+	if (!(ldexp(m_center.y, 1) - spacing * BigFloat<64>(halfRows)).isZero())
+		return false;
+	
+	mirror = row;
+	return true;
+}
+
+
+Vector2fe Viewport::toOffset(Vector2lf pixels) const
+{
+	if (isRotated())
+	{
+		pixels = Vector2lf(pixels.x * m_cos + pixels.y * m_sin,
+						   pixels.y * m_cos - pixels.x * m_sin);
+	}
+	
+	return Vector2fe(pixels.x * m_pixelSpacing, pixels.y * m_pixelSpacing);
+}
@@ -0,0 +1,95 @@
+
+/*
+ *  Viewport.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *  
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *  
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *  
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *  
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef VIEWPORT_HPP
+#define VIEWPORT_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include "DoubleDouble.hpp"
+#include "QuadDouble.hpp"
+#include "BigFloat.hpp"
+#include "FloatExp.hpp"
+
+typedef sf::Vector2<double>        Vector2lf;
+typedef sf::Vector2<DoubleDouble>  Vector2dd;
+typedef sf::Vector2<QuadDouble>    Vector2qd;
+typedef sf::Vector2<BigFloat<64> > Vector2bf;
+typedef sf::Vector2<FloatExp>      Vector2fe;
+
+// Part of the complex plane shown in a pixel buffer: the point at the center
+// pixel, kept in full precision, the distance between two neighbour pixels
+// and the rotation of the view around its center. Pixels are only located
+// by their offset from another pixel, which is small enough to be exact in
+// floatexp, so that no coordinate overflows or gets rounded to a coarser
+// grid at any zoom.
+class Viewport {
+public:
+	Viewport(unsigned width, unsigned height);
+	
+	void setCenter(const Vector2bf& center);
+	void setZoom(const FloatExp& zoom);
+	
+	// Angle of the view around its center, in degrees
+	void setRotation(double rotation);
+	
+	// Moves the center by the given number of pixels, along the axes of the
+	// pixel buffer
+	void move(Vector2lf pixels);
+	
+	unsigned getWidth(void) const;
+	unsigned getHeight(void) const;
+	const Vector2bf& getCenter(void) const;
+	FloatExp getZoom(void) const;
+	double getRotation(void) const;
+	bool isRotated(void) const;
+	const FloatExp& getPixelSpacing(void) const;
+	sf::Vector2u getCenterPixel(void) const;
+	
+	Vector2fe getOffset(sf::Vector2u from, unsigned image_x, unsigned image_y) const;
+	
+	// Offset of a position between pixels, in pixels of the buffer
+	Vector2fe getOffset(sf::Vector2u from, Vector2lf position) const;
+	Vector2bf getCoordinates(unsigned image_x, unsigned image_y) const;
+	
+	// When the view is not rotated and the real axis lies exactly on a row or
+	// halfway between two rows, the rows y and 'mirror - y' show conjugate points
+	bool getMirror(unsigned& mirror) const;
+	
+private:
+	unsigned m_width;
+	unsigned m_height;
+	Vector2bf m_center;
+	FloatExp m_zoom;
+	FloatExp m_pixelSpacing;
+	double m_rotation;
+	double m_cos;
+	double m_sin;
+	
+	Vector2fe toOffset(Vector2lf pixels) const;
+};
+
+#endif
@@ -27,9 +27,24 @@
 
 #include <SFML/Graphics.hpp>
 #include "Application.hpp"
+#include "KernelRegistry.hpp"
+#include "Benchmark.hpp"
+#include <string>
 
-int main()
+int main(int argc, char *argv[])
 {
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		
+		if (arg.compare(0, 9, "--kernel=") == 0)
+			KernelRegistry::select(arg.substr(9));
+		else if (arg == "--kernel" && i + 1 < argc)
+			KernelRegistry::select(argv[++i]);
+		else if (arg == "--benchmark")
+			return runBenchmark();
+	}
+	
 	sf::RenderWindow window(sf::VideoMode::getDesktopMode(), "Mandelbrot Fractal Explorer", sf::Style::Fullscreen);
 	window.setFramerateLimit(60);
 	window.setMouseCursorVisible(false);